@@ -5,6 +5,7 @@
 #include "Perception/PawnSensingComponent.h"
 #include "AIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
 #include "DrawDebugHelpers.h"
 #include "SAttributeComponent.h"
 #include "BrainComponent.h"
@@ -13,6 +14,9 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "SActionComponent.h"
+#include "AI/SBotRegistrySubsystem.h"
+#include "AI/SBotPoolSubsystem.h"
+#include "Net/UnrealNetwork.h"
 
 // Sets default values
 ASAICharacter::ASAICharacter()
@@ -33,6 +37,12 @@ ASAICharacter::ASAICharacter()
 
     TimeToHitParamName = "TimeToHit";
     TargetActorKey = "TargetActor";
+
+    BotRegistryIndex = INDEX_NONE;
+
+    RagdollDuration = 10.0f;
+    bIsPooled = false;
+    ReuseCount = 0;
 }
 
 void ASAICharacter::PostInitializeComponents()
@@ -42,6 +52,39 @@ void ASAICharacter::PostInitializeComponents()
     PawnSensingComp->OnSeePawn.AddDynamic(this, &ASAICharacter::OnPawnSeen);
 
     AttributeComp->OnHealthChanged.AddDynamic(this, &ASAICharacter::OnHealthChanged);
+
+    MeshRelativeTransform = GetMesh()->GetRelativeTransform();
+    MeshCollisionProfileName = GetMesh()->GetCollisionProfileName();
+    CapsuleCollisionEnabled = GetCapsuleComponent()->GetCollisionEnabled();
+}
+
+void ASAICharacter::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Let the registry know about us, so GameMode can count/iterate alive bots without TActorIterator
+    USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+    if (BotRegistry && AttributeComp->IsAlive() && !bIsPooled)
+    {
+        BotRegistry->RegisterBot(this);
+    }
+}
+
+void ASAICharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Destroyed while still alive (e.g. level unload), make sure the registry does not keep a dangling entry
+    UnregisterFromBotRegistry();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASAICharacter::UnregisterFromBotRegistry()
+{
+    USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+    if (BotRegistry)
+    {
+        BotRegistry->UnregisterBot(this);
+    }
 }
 
 void ASAICharacter::OnHealthChanged(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta)
@@ -68,6 +111,9 @@ void ASAICharacter::OnHealthChanged(AActor* InstigatorActor, USAttributeComponen
 
         if (NewHealth <= 0.0f) // AI Character just died
         {
+            // no longer counts towards alive bots, even though the ragdoll stays around until lifespan expires
+            UnregisterFromBotRegistry();
+
             // stop BT
             AAIController* AIC = Cast<AAIController>(GetController());
             if (AIC) // the pawn may become UnPossessed by other code resulting in AIC being nullptr
@@ -82,10 +128,139 @@ void ASAICharacter::OnHealthChanged(AActor* InstigatorActor, USAttributeComponen
             GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision); // disable collision in capsule component left behind by dead AI character (use Show Collision to see it in Editor)
             GetCharacterMovement()->DisableMovement();
 
-            // set lifespan
-            SetLifeSpan(10.0f);
+            // Keep the ragdoll around for a while, then recycle the bot (server only, clients follow through replication).
+            // Without a pool fall back to the lifespan.
+            USBotPoolSubsystem* BotPool = GetWorld()->GetSubsystem<USBotPoolSubsystem>();
+            if (BotPool && HasAuthority())
+            {
+                GetWorldTimerManager().SetTimer(TimerHandle_ReturnToPool, this, &ASAICharacter::ReturnToPool, RagdollDuration);
+            }
+            else
+            {
+                SetLifeSpan(RagdollDuration);
+            }
+        }
+
+    }
+}
+
+void ASAICharacter::ReturnToPool()
+{
+    USBotPoolSubsystem* BotPool = GetWorld()->GetSubsystem<USBotPoolSubsystem>();
+    if (BotPool)
+    {
+        BotPool->ReleaseBot(this);
+    }
+    else
+    {
+        Destroy();
+    }
+}
+
+void ASAICharacter::DeactivateForPool()
+{
+    bIsPooled = true;
+
+    GetWorldTimerManager().ClearTimer(TimerHandle_ReturnToPool);
+
+    UnregisterFromBotRegistry();
+
+    // Keep possessed by the same AI controller (that is the whole point), just make sure the brain is idle
+    AAIController* AIC = Cast<AAIController>(GetController());
+    if (AIC && AIC->GetBrainComponent())
+    {
+        AIC->GetBrainComponent()->StopLogic("Pooled");
+    }
+
+    // Wipe every blackboard key, not just TargetActor. Services write keys like AttackRange and LowHealth
+    // that would otherwise leak into the next life and drive the tree before they get re-evaluated.
+    // (InitializeBlackboard() with the same asset is a no-op, so clear the values one by one)
+    UBlackboardComponent* BBComp = AIC ? AIC->GetBlackboardComponent() : nullptr;
+    if (BBComp && BBComp->GetBlackboardAsset())
+    {
+        const int32 NumKeys = BBComp->GetBlackboardAsset()->GetNumKeys();
+        for (int32 KeyIndex = 0; KeyIndex < NumKeys; KeyIndex++)
+        {
+            BBComp->ClearValue(static_cast<FBlackboard::FKey>(KeyIndex));
         }
+    }
+
+    PawnSensingComp->SetSensingUpdatesEnabled(false);
+
+    RestoreBodyAfterRagdoll();
+    GetCharacterMovement()->DisableMovement();
+
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+
+    RemoveHealthBar();
+
+    // Reset gameplay state, monster specific actions are granted again by GameMode on reuse
+    AttributeComp->ResetAttributes();
+    ActionComp->ResetActions();
+}
+
+void ASAICharacter::ActivateFromPool(const FVector& Location, const FRotator& Rotation)
+{
+    bIsPooled = false;
+    ReuseCount++;
+
+    SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+
+    RestoreBodyAfterRagdoll();
+
+    PawnSensingComp->SetSensingUpdatesEnabled(true);
+
+    AAIController* AIC = Cast<AAIController>(GetController());
+    if (AIC && AIC->GetBrainComponent())
+    {
+        AIC->GetBrainComponent()->RestartLogic();
+    }
+
+    USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+    if (BotRegistry)
+    {
+        BotRegistry->RegisterBot(this);
+    }
+
+    ForceNetUpdate();
+}
 
+bool ASAICharacter::IsPooled() const
+{
+    return bIsPooled;
+}
+
+void ASAICharacter::OnRep_ReuseCount()
+{
+    // Clients ragdolled the bot themselves through OnHealthChanged, undo that before it shows up again
+    RestoreBodyAfterRagdoll();
+    RemoveHealthBar();
+}
+
+void ASAICharacter::RestoreBodyAfterRagdoll()
+{
+    USkeletalMeshComponent* MeshComp = GetMesh();
+    MeshComp->SetAllBodiesSimulatePhysics(false);
+    MeshComp->SetCollisionProfileName(MeshCollisionProfileName);
+
+    // Simulating physics detached the mesh from the capsule
+    MeshComp->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+    MeshComp->SetRelativeTransform(MeshRelativeTransform);
+
+    GetCapsuleComponent()->SetCollisionEnabled(CapsuleCollisionEnabled);
+    GetCharacterMovement()->SetDefaultMovementMode();
+}
+
+void ASAICharacter::RemoveHealthBar()
+{
+    if (ActiveHealthBar)
+    {
+        ActiveHealthBar->RemoveFromParent();
+        ActiveHealthBar = nullptr;
     }
 }
 
@@ -133,4 +308,11 @@ void ASAICharacter::MulticastPawnSeen_Implementation() // _Implementation for Ne
         // May end up behind the minion health bar otherwise.
         NewWidget->AddToViewport(10);
     }
+}
+
+void ASAICharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(ASAICharacter, ReuseCount);
 }
\ No newline at end of file
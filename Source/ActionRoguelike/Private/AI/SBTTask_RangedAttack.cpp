@@ -6,6 +6,8 @@
 #include "SCharacter.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "SAttributeComponent.h"
+#include "SProjectilePoolSubsystem.h"
+#include "SRandomSubsystem.h"
 
 
 USBTTask_RangedAttack::USBTTask_RangedAttack()
@@ -40,14 +42,15 @@ EBTNodeResult::Type USBTTask_RangedAttack::ExecuteTask(UBehaviorTreeComponent& O
 		FVector Direction = TargetActor->GetActorLocation() - MuzzleLocation;
 		FRotator MuzzleRotation = Direction.Rotation();
 
-		MuzzleRotation.Pitch += FMath::RandRange(0.0f, maxBulletSpread); // ignore negative pitch to NOT allow shooting at the floor since it makes the AI look dumb
-		MuzzleRotation.Yaw += FMath::RandRange(-maxBulletSpread, maxBulletSpread);
+		// Seeded stream so a replayed match (same ?Seed=) fires the same spread
+		FRandomStream& CombatStream = GetWorld()->GetSubsystem<USRandomSubsystem>()->GetStream(USRandomSubsystem::CombatChannel);
 
-		FActorSpawnParameters Params;
-		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		Params.Instigator = MyPawn; // avoid MagicProjectile self-damaging the AI bot (there is an instigator check inside SMagicProjectile)
+		MuzzleRotation.Pitch += CombatStream.FRandRange(0.0f, maxBulletSpread); // ignore negative pitch to NOT allow shooting at the floor since it makes the AI look dumb
+		MuzzleRotation.Yaw += CombatStream.FRandRange(-maxBulletSpread, maxBulletSpread);
 
-		AActor* NewProj = GetWorld()->SpawnActor<AActor>(ProjectileClass, MuzzleLocation, MuzzleRotation, Params);
+		// MyPawn as instigator avoids MagicProjectile self-damaging the AI bot (there is an instigator check inside SMagicProjectile)
+		USProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<USProjectilePoolSubsystem>();
+		AActor* NewProj = ProjectilePool->AcquireProjectile(ProjectileClass, FTransform(MuzzleRotation, MuzzleLocation), MyPawn);
 
 		return NewProj ? EBTNodeResult::Succeeded : EBTNodeResult::Failed;
 	}
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AI/SBotPoolSubsystem.h"
+#include "AI/SAICharacter.h"
+#include "TimerManager.h"
+#include "../../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Pool Hits"), STAT_BotPoolHits, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Pool Misses"), STAT_BotPoolMisses, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Bots"), STAT_PooledBots, STATGROUP_STANFORD);
+
+void USBotPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WarmUpSpawnsPerFrame = 2;
+	NumPoolHits = 0;
+	NumPoolMisses = 0;
+}
+
+void USBotPoolSubsystem::Deinitialize()
+{
+	for (auto& Entry : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_PooledBots, Entry.Value.Bots.Num());
+	}
+	Pools.Empty();
+	PendingWarmUps.Empty();
+
+	Super::Deinitialize();
+}
+
+ASAICharacter* USBotPoolSubsystem::AcquireBot(UClass* BotClass, const FVector& Location, const FRotator& Rotation)
+{
+	FBotPoolBucket* Bucket = Pools.Find(BotClass);
+	while (Bucket && Bucket->Bots.Num() > 0)
+	{
+		ASAICharacter* Bot = Bucket->Bots.Pop(false);
+		DEC_DWORD_STAT(STAT_PooledBots);
+
+		// Could have been destroyed by something else (e.g. level streaming) while sitting in the pool
+		if (IsValid(Bot))
+		{
+			Bot->ActivateFromPool(Location, Rotation);
+
+			NumPoolHits++;
+			INC_DWORD_STAT(STAT_BotPoolHits);
+			return Bot;
+		}
+	}
+
+	NumPoolMisses++;
+	INC_DWORD_STAT(STAT_BotPoolMisses);
+	return nullptr;
+}
+
+void USBotPoolSubsystem::ReleaseBot(ASAICharacter* Bot)
+{
+	if (!ensure(Bot) || Bot->IsPooled())
+	{
+		return;
+	}
+
+	Bot->DeactivateForPool();
+
+	Pools.FindOrAdd(Bot->GetClass()).Bots.Add(Bot);
+	INC_DWORD_STAT(STAT_PooledBots);
+}
+
+void USBotPoolSubsystem::RequestWarmUp(TSubclassOf<AActor> BotClass, int32 Count)
+{
+	// Only ASAICharacter knows how to deactivate itself
+	TSubclassOf<ASAICharacter> AIClass = *BotClass;
+	if (AIClass == nullptr || Count <= 0)
+	{
+		return;
+	}
+
+	PendingWarmUps.Add(TPair<TSubclassOf<ASAICharacter>, int32>(AIClass, Count));
+
+	if (!TimerHandle_WarmUp.IsValid())
+	{
+		TimerHandle_WarmUp = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &USBotPoolSubsystem::ProcessWarmUp);
+	}
+}
+
+void USBotPoolSubsystem::ProcessWarmUp()
+{
+	TimerHandle_WarmUp.Invalidate();
+
+	UWorld* World = GetWorld();
+
+	// Wait for the match to begin, spawned bots would otherwise get their BeginPlay (and start their behavior tree) after being pooled
+	int32 SpawnBudget = World->HasBegunPlay() ? WarmUpSpawnsPerFrame : 0;
+
+	while (SpawnBudget > 0 && PendingWarmUps.Num() > 0)
+	{
+		TPair<TSubclassOf<ASAICharacter>, int32>& Request = PendingWarmUps[0];
+		if (GetNumPooledBots(Request.Key) >= Request.Value)
+		{
+			PendingWarmUps.RemoveAt(0);
+			continue;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		// Hidden and without collision right after this, location does not matter
+		ASAICharacter* Bot = World->SpawnActor<ASAICharacter>(Request.Key, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+		if (Bot == nullptr)
+		{
+			PendingWarmUps.RemoveAt(0);
+			continue;
+		}
+
+		ReleaseBot(Bot);
+		SpawnBudget--;
+	}
+
+	if (PendingWarmUps.Num() > 0)
+	{
+		TimerHandle_WarmUp = World->GetTimerManager().SetTimerForNextTick(this, &USBotPoolSubsystem::ProcessWarmUp);
+	}
+}
+
+int32 USBotPoolSubsystem::GetNumPooledBots(UClass* BotClass) const
+{
+	const FBotPoolBucket* Bucket = Pools.Find(BotClass);
+	return Bucket ? Bucket->Bots.Num() : 0;
+}
+
+void USBotPoolSubsystem::LogStats() const
+{
+	for (const auto& Entry : Pools)
+	{
+		UE_LOG(LogTemp, Log, TEXT("BotPool: %s : %i pooled."), *GetNameSafe(Entry.Key), Entry.Value.Bots.Num());
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BotPool: hits: %i, misses: %i."), NumPoolHits, NumPoolMisses);
+}
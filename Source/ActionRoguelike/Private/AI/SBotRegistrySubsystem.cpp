@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AI/SBotRegistrySubsystem.h"
+#include "AI/SAICharacter.h"
+#include "../../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Alive Bots"), STAT_AliveBots, STATGROUP_STANFORD);
+
+void USBotRegistrySubsystem::RegisterBot(ASAICharacter* Bot)
+{
+	if (!ensure(Bot) || Bot->BotRegistryIndex != INDEX_NONE) // already registered
+	{
+		return;
+	}
+
+	Bot->BotRegistryIndex = AliveBots.Add(Bot);
+
+	INC_DWORD_STAT(STAT_AliveBots);
+}
+
+void USBotRegistrySubsystem::UnregisterBot(ASAICharacter* Bot)
+{
+	if (Bot == nullptr || !AliveBots.IsValidIndex(Bot->BotRegistryIndex) || AliveBots[Bot->BotRegistryIndex] != Bot)
+	{
+		return;
+	}
+
+	// O(1) removal : move the last bot into the freed slot instead of shifting the whole array
+	int32 RemovedIndex = Bot->BotRegistryIndex;
+	AliveBots.RemoveAtSwap(RemovedIndex, 1, false);
+	if (AliveBots.IsValidIndex(RemovedIndex))
+	{
+		AliveBots[RemovedIndex]->BotRegistryIndex = RemovedIndex;
+	}
+
+	Bot->BotRegistryIndex = INDEX_NONE;
+
+	DEC_DWORD_STAT(STAT_AliveBots);
+}
+
+int32 USBotRegistrySubsystem::GetNumAliveBots() const
+{
+	return AliveBots.Num();
+}
+
+const TArray<ASAICharacter*>& USBotRegistrySubsystem::GetAliveBots() const
+{
+	return AliveBots;
+}
+
+void USBotRegistrySubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_AliveBots, AliveBots.Num());
+
+	for (ASAICharacter* Bot : AliveBots)
+	{
+		if (Bot)
+		{
+			Bot->BotRegistryIndex = INDEX_NONE;
+		}
+	}
+	AliveBots.Empty();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AI/SSpawnLocationCache.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "EnvironmentQuery/EnvQueryInstanceBlueprintWrapper.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "../../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawn Location Queries"), STAT_SpawnLocationQueries, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawn Locations Handed Out"), STAT_SpawnLocationsHandedOut, STATGROUP_STANFORD);
+
+void USSpawnLocationCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SpawnQuery = nullptr;
+	Querier = nullptr;
+	NumAvailable = 0;
+	RefreshDistance = 1500.0f;
+	MinAvailable = 5;
+	BestCandidateFraction = 0.05f;
+	bQueryInFlight = false;
+	RetryCooldown = 2.0f;
+	NextQueryTime = 0.0f;
+	NumQueries = 0;
+	NumLocationsHandedOut = 0;
+}
+
+void USSpawnLocationCache::Setup(UEnvQuery* InSpawnQuery, UObject* InQuerier, float InRefreshDistance, int32 InMinAvailable)
+{
+	SpawnQuery = InSpawnQuery;
+	Querier = InQuerier;
+	RefreshDistance = InRefreshDistance;
+	MinAvailable = FMath::Max(InMinAvailable, 1);
+
+	Candidates.Reset();
+	NumAvailable = 0;
+	NextQueryTime = 0.0f;
+
+	RequestRefresh();
+}
+
+void USSpawnLocationCache::UpdateCache()
+{
+	if (bQueryInFlight)
+	{
+		return;
+	}
+
+	if (IsRunningLow() || HavePlayersMoved())
+	{
+		RequestRefresh();
+	}
+}
+
+bool USSpawnLocationCache::IsRunningLow() const
+{
+	return Candidates.Num() == 0 || NumAvailable < FMath::Min(MinAvailable, Candidates.Num());
+}
+
+void USSpawnLocationCache::RequestRefresh()
+{
+	if (bQueryInFlight || SpawnQuery == nullptr || Querier == nullptr)
+	{
+		return;
+	}
+
+	// Last query failed or came back empty, don't hammer EQS with the same request every tick
+	if (GetWorld()->GetTimeSeconds() < NextQueryTime)
+	{
+		return;
+	}
+
+	// All results (sorted by score) so a single query can serve many waves
+	UEnvQueryInstanceBlueprintWrapper* QueryInstance = UEnvQueryManager::RunEQSQuery(this, SpawnQuery, Querier, EEnvQueryRunMode::AllMatching, nullptr);
+	if (ensure(QueryInstance))
+	{
+		bQueryInFlight = true;
+		QueryInstance->GetOnQueryFinishedEvent().AddDynamic(this, &USSpawnLocationCache::OnSpawnQueryCompleted);
+
+		// Snapshot now rather than on completion, players keep moving while the query runs
+		GatherPlayerLocations(QueriedPlayerLocations);
+
+		NumQueries++;
+		INC_DWORD_STAT(STAT_SpawnLocationQueries);
+	}
+}
+
+void USSpawnLocationCache::OnSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrapper* QueryInstance, EEnvQueryStatus::Type QueryStatus)
+{
+	bQueryInFlight = false;
+
+	if (QueryStatus != EEnvQueryStatus::Success)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Spawn bot EQS Query failed!"));
+		NextQueryTime = GetWorld()->GetTimeSeconds() + RetryCooldown;
+		return;
+	}
+
+	TArray<FVector> Results = QueryInstance->GetResultsAsLocations();
+	if (Results.Num() == 0)
+	{
+		// Keep whatever we had left, better than nothing
+		NextQueryTime = GetWorld()->GetTimeSeconds() + RetryCooldown;
+		return;
+	}
+
+	// Results are sorted by score, keep the best ones (at least enough for a refill)
+	int32 NumToKeep = FMath::Min(Results.Num(), FMath::Max(MinAvailable, FMath::CeilToInt(Results.Num() * BestCandidateFraction)));
+	Results.SetNum(NumToKeep, false);
+
+	Candidates = MoveTemp(Results);
+	NumAvailable = Candidates.Num();
+}
+
+int32 USSpawnLocationCache::TakeLocations(int32 Count, const FRandomStream& RandomStream, TArray<FVector>& OutLocations)
+{
+	int32 NumTaken = 0;
+	while (NumTaken < Count && NumAvailable > 0)
+	{
+		int32 PickedIndex = RandomStream.RandHelper(NumAvailable);
+		OutLocations.Add(Candidates[PickedIndex]);
+
+		// Swap the used location out of the available range so bots don't stack
+		NumAvailable--;
+		Candidates.Swap(PickedIndex, NumAvailable);
+
+		NumTaken++;
+	}
+
+	NumLocationsHandedOut += NumTaken;
+	INC_DWORD_STAT_BY(STAT_SpawnLocationsHandedOut, NumTaken);
+
+	// Start refilling before we fully run dry
+	if (IsRunningLow())
+	{
+		RequestRefresh();
+	}
+
+	return NumTaken;
+}
+
+void USSpawnLocationCache::GatherPlayerLocations(TArray<FVector>& OutLocations) const
+{
+	OutLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			OutLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+}
+
+bool USSpawnLocationCache::HavePlayersMoved() const
+{
+	TArray<FVector> PlayerLocations;
+	GatherPlayerLocations(PlayerLocations);
+
+	// Players joined, left or (re)spawned
+	if (PlayerLocations.Num() != QueriedPlayerLocations.Num())
+	{
+		return true;
+	}
+
+	const float RefreshDistanceSq = RefreshDistance * RefreshDistance;
+	for (int32 i = 0; i < PlayerLocations.Num(); i++)
+	{
+		if (FVector::DistSquared(PlayerLocations[i], QueriedPlayerLocations[i]) > RefreshDistanceSq)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void USSpawnLocationCache::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("SpawnLocationCache: %i/%i candidates available, queries: %i, locations handed out: %i."),
+		NumAvailable, Candidates.Num(), NumQueries, NumLocationsHandedOut);
+}
@@ -4,7 +4,13 @@
 #include "SAction.h"
 #include "SActionComponent.h"
 #include "../ActionRoguelike.h"
-#include "Net/UnrealNetwork.h"
+
+USAction::USAction()
+{
+	ActionListIndex = INDEX_NONE;
+	TimeReleased = 0.0f;
+	bPooled = false;
+}
 
 void USAction::Initialize(USActionComponent* NewActionComp)
 {
@@ -42,12 +48,19 @@ void USAction::StartAction_Implementation(AActor* Instigator)
 	RepData.bIsRunning = true;
 	RepData.Instigator = Instigator;
 
+	if (bTickWhileRunning)
+	{
+		Comp->SetActionTicking(this, true);
+	}
+
 	// this part should only run on the server - alternative check to HasAuthority showcased here.
 	if (GetOwningComponent()->GetOwnerRole() == ROLE_Authority) 
 	{
 		TimeStarted = GetWorld()->TimeSeconds; // TimeStarted now set on server and since it is replicated it has the same value for all clients
 	}
 
+	Comp->MarkActionDirty(this);
+
 	// TODO: we could replace GetOwningComponent() with Comp variable created above but currently following class code 1:1
 	GetOwningComponent()->OnActionStarted.Broadcast(GetOwningComponent(), this);
 }
@@ -77,10 +90,30 @@ void USAction::StopAction_Implementation(AActor* Instigator)
 	RepData.bIsRunning = false;
 	RepData.Instigator = Instigator;
 
+	if (bTickWhileRunning)
+	{
+		Comp->SetActionTicking(this, false);
+	}
+
+	Comp->MarkActionDirty(this);
+
 	// TODO: we could replace GetOwningComponent() with Comp variable created above but currently following class code 1:1
 	GetOwningComponent()->OnActionStopped.Broadcast(GetOwningComponent(), this);
 }
 
+void USAction::ResetAction_Implementation()
+{
+	// ActionComp stays, pooled actions are only reused by the component they were created for.
+	// Both replicate like any other change, clients see a stopped action start again.
+	RepData.bIsRunning = false;
+	RepData.Instigator = nullptr;
+	TimeStarted = 0.0f;
+}
+
+void USAction::TickAction_Implementation(float DeltaTime)
+{
+}
+
 UWorld* USAction::GetWorld() const
 {
 	// Outer is set when creating action via NewObject<T> (in USActionComponent::AddAction)
@@ -125,17 +158,25 @@ void USAction::OnRep_RepData()
 	}
 }
 
-bool USAction::IsRunning() const
+void USAction::GetRepState(FActionListEntry& Entry) const
 {
-	return RepData.bIsRunning;
+	Entry.RepData = RepData;
+	Entry.TimeStarted = TimeStarted;
 }
 
-void USAction::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const //function is defined in the ClassName.generated.h
+void USAction::ApplyRepState(const FActionListEntry& Entry)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	TimeStarted = Entry.TimeStarted;
+
+	// Same rule as the RepNotify this replaced : a client that already changed RepData itself (started the action locally) doesn't run it again
+	if (Entry.RepData.bIsRunning != RepData.bIsRunning || Entry.RepData.Instigator != RepData.Instigator)
+	{
+		RepData = Entry.RepData;
+		OnRep_RepData();
+	}
+}
 
-	DOREPLIFETIME(USAction, RepData);
-	DOREPLIFETIME(USAction, ActionComp);
-	//DOREPLIFETIME_CONDITION_NOTIFY(USAction, ActionComp, COND_None, REPNOTIFY_Always); // see NOTE above bIsRunning in SAction.h
-	DOREPLIFETIME(USAction, TimeStarted);
-}
\ No newline at end of file
+bool USAction::IsRunning() const
+{
+	return RepData.bIsRunning;
+}
@@ -3,11 +3,19 @@
 
 #include "SActionComponent.h"
 #include "SAction.h"
+#include "SActionEffect.h"
 #include "../ActionRoguelike.h"
 #include "Net/UnrealNetwork.h"
-#include "Engine/ActorChannel.h"
+#include "UObject/UObjectIterator.h"
+#include "SActionDebugger.h"
 
 DECLARE_CYCLE_STAT(TEXT("StartActionByName"), STAT_StartActionByName, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("ActionComponent Tick"), STAT_ActionComponentTick, STATGROUP_STANFORD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ticking ActionComponents"), STAT_TickingActionComponents, STATGROUP_STANFORD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Action Pool Hits"), STAT_ActionPoolHits, STATGROUP_STANFORD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Action Pool Misses"), STAT_ActionPoolMisses, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("ActionList NetDeltaSerialize"), STAT_ActionListNetDeltaSerialize, STATGROUP_STANFORD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ActionList Entries Dirtied"), STAT_ActionListEntriesDirtied, STATGROUP_STANFORD);
 
 
 
@@ -16,9 +24,23 @@ USActionComponent::USActionComponent()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
+	// Every player and bot has one : tick is only enabled while an action with bTickWhileRunning runs (see SetActionTicking)
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	SetIsReplicatedByDefault(true);
+
+	MaxPooledActionsPerClass = 8;
+	NumPoolHits = 0;
+	NumPoolMisses = 0;
+}
+
+void USActionComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// After InitProperties, which copies the whole ActionList (C++ copy, so even non UPROPERTY members) from our archetype
+	ActionList.OwnerComp = this;
 }
 
 // Called when the game starts
@@ -26,6 +48,10 @@ void USActionComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+#if !UE_BUILD_SHIPPING
+	FActionDebugger::AddComponent(this);
+#endif
+
 	// Server-only
 	if (GetOwner()->HasAuthority())
 	{
@@ -41,8 +67,17 @@ void USActionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	// The need for implementing EndPlay rises when a minion Enemy gets destroyed (after it dies) while still having an action-effect applied (e.g. burning).
 	// The action-effect would continue to execute for a "pending-kill" actor resulting in errors in message log. 
 	// The following code is a suitable fix, stopping all running actions after the Owning Actor calls EndPlay() when destroyed.
+	StopAllActions();
+
+#if !UE_BUILD_SHIPPING
+	FActionDebugger::RemoveComponent(this);
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
 
-	// Stop all
+void USActionComponent::StopAllActions()
+{
 	TArray<USAction*> ActionsCopy = Actions; // make a copy of Actions Array to avoid potential error mentioned below in the comments.
 	for (USAction* Action : ActionsCopy)
 	{
@@ -53,27 +88,166 @@ void USActionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 											// Hence the need for copying the whole Actions Array to ActionsCopy variable for stopping the actions.
 		}
 	}
+}
 
-	Super::EndPlay(EndPlayReason);
+void USActionComponent::ResetActions()
+{
+	StopAllActions();
+
+	// Anything poolable is reused by the DefaultActions granted below
+	if (GetOwner()->HasAuthority())
+	{
+		for (USAction* Action : Actions)
+		{
+			if (Action && !Action->IsRunning())
+			{
+				Action->ActionListIndex = INDEX_NONE;
+				ReleaseAction(Action);
+			}
+		}
+
+		ActionList.Items.Reset();
+		ActionList.MarkArrayDirty();
+	}
+
+	Actions.Reset();
+	TickingActions.Reset();
+	SetComponentTickEnabled(false);
+	ActionsByName.Reset();
+	ActionsByClass.Reset();
+	ActiveGameplayTags.Reset();
+
+	// Server-only, same as BeginPlay
+	if (GetOwner()->HasAuthority())
+	{
+		for (TSubclassOf<USAction> ActionClass : DefaultActions)
+		{
+			AddAction(GetOwner(), ActionClass);
+		}
+	}
 }
 
 
-// Called every frame
+// Only while TickingActions is not empty. Debug drawing of actions moved to FActionDebugger (su.ActionDebug 1).
 void USActionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	//FString DebugMsg = GetNameSafe(GetOwner()) + " : " + ActiveGameplayTags.ToStringSimple();
-	//GEngine->AddOnScreenDebugMessage(-1, 0.0f, FColor::White, DebugMsg);
+	SCOPE_CYCLE_COUNTER(STAT_ActionComponentTick);
+	INC_DWORD_STAT(STAT_TickingActionComponents);
 
-	// Draw All Actions
-	for (USAction* Action : Actions)
+	// An action may stop itself (or others) while ticking
+	TArray<USAction*, TInlineAllocator<4>> ActionsToTick(TickingActions);
+	for (USAction* Action : ActionsToTick)
 	{
-		FColor TextColor = Action->IsRunning() ? FColor::Blue : FColor::White;
-		FString ActionMsg = FString::Printf(TEXT("[%s] Action: %s"), *GetNameSafe(GetOwner()), *GetNameSafe(Action));
+		if (Action->IsRunning())
+		{
+			Action->TickAction(DeltaTime);
+		}
+	}
+}
 
-		LogOnScreen(this, ActionMsg, TextColor, 0.0f);
+void USActionComponent::SetActionTicking(USAction* Action, bool bTicking)
+{
+	if (bTicking)
+	{
+		TickingActions.AddUnique(Action);
+	}
+	else
+	{
+		TickingActions.Remove(Action);
 	}
+
+	SetComponentTickEnabled(TickingActions.Num() > 0);
+}
+
+void USActionComponent::LogLookupBenchmark(AActor* Owner, int32 NumActions, int32 NumLookups)
+{
+	if (Owner == nullptr || NumActions <= 0 || NumLookups <= 0)
+	{
+		return;
+	}
+
+	// Not registered, nothing ticks or replicates. Collected by GC with its actions once we're done.
+	USActionComponent* Comp = NewObject<USActionComponent>(Owner, NAME_None, RF_Transient);
+
+	// Unique names, the last action is the only effect so finding it by class is the worst case for the scan
+	for (int32 i = 0; i < NumActions; i++)
+	{
+		TSubclassOf<USAction> ActionClass = (i == NumActions - 1) ? USActionEffect::StaticClass() : USAction::StaticClass();
+
+		USAction* Action = NewObject<USAction>(Owner, ActionClass, NAME_None, RF_Transient);
+		Action->ActionName = FName(TEXT("BenchmarkAction"), i);
+		Action->Initialize(Comp);
+
+		Comp->Actions.Add(Action);
+		Comp->AddToIndex(Action);
+	}
+
+	TArray<FName> LookupNames;
+	LookupNames.SetNum(NumLookups);
+
+	FRandomStream Stream(NumActions);
+	for (FName& Name : LookupNames)
+	{
+		Name = FName(TEXT("BenchmarkAction"), Stream.RandRange(0, NumActions - 1));
+	}
+
+	// Same loop StartActionByName/StopActionByName used before the index
+	int32 ScanHits = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (FName Name : LookupNames)
+	{
+		for (USAction* Action : Comp->Actions)
+		{
+			if (Action && Action->ActionName == Name)
+			{
+				ScanHits++;
+				break;
+			}
+		}
+	}
+	double ScanNameMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	int32 IndexHits = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (FName Name : LookupNames)
+	{
+		if (Comp->ActionsByName.Find(Name))
+		{
+			IndexHits++;
+		}
+	}
+	double IndexNameMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumLookups; i++)
+	{
+		for (USAction* Action : Comp->Actions)
+		{
+			if (Action && Action->IsA(USActionEffect::StaticClass()))
+			{
+				ScanHits++;
+				break;
+			}
+		}
+	}
+	double ScanClassMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumLookups; i++)
+	{
+		if (Comp->GetAction(USActionEffect::StaticClass()))
+		{
+			IndexHits++;
+		}
+	}
+	double IndexClassMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Hits are only logged so the loops can't be optimized away, both should be 2 * NumLookups
+	UE_LOG(LogTemp, Log, TEXT("ActionLookupBenchmark: %i actions, %i lookups (hits scan: %i, index: %i)"), NumActions, NumLookups, ScanHits, IndexHits);
+	UE_LOG(LogTemp, Log, TEXT("  By name  : scan %.2f ns, index %.2f ns per lookup"), ScanNameMs * 1000000.0 / NumLookups, IndexNameMs * 1000000.0 / NumLookups);
+	UE_LOG(LogTemp, Log, TEXT("  By class : scan %.2f ns, index %.2f ns per lookup"), ScanClassMs * 1000000.0 / NumLookups, IndexClassMs * 1000000.0 / NumLookups);
 }
 
 void USActionComponent::AddAction(AActor* Instigator, TSubclassOf<USAction> ActionClass)
@@ -90,12 +264,30 @@ void USActionComponent::AddAction(AActor* Instigator, TSubclassOf<USAction> Acti
 		return;
 	}
 
-	USAction* NewAction = NewObject<USAction>(GetOwner(), ActionClass); // setting Outer to Actor owning Component. Also see USAction::GetWorld() implementation.
+	// Reapplying a running effect (e.g. burning on every hit) merges into it instead of adding another instance, unless it opted out (Independent)
+	USActionEffect* RunningEffect = Cast<USActionEffect>(GetAction(ActionClass));
+	if (RunningEffect && RunningEffect->GetClass() == ActionClass && RunningEffect->IsRunning()
+		&& RunningEffect->GetStackingPolicy() != EEffectStackingPolicy::Independent)
+	{
+		RunningEffect->Reapply(Instigator);
+		return;
+	}
+
+	USAction* NewAction = AcquireAction(ActionClass);
 	if (ensure(NewAction))
 	{
 		NewAction->Initialize(this);
 
 		Actions.Add(NewAction);
+		AddToIndex(NewAction);
+
+		// Clients create their own copy once this entry reaches them
+		NewAction->ActionListIndex = ActionList.Items.AddDefaulted();
+		FActionListEntry& Entry = ActionList.Items[NewAction->ActionListIndex];
+		Entry.ActionClass = ActionClass;
+		Entry.Action = NewAction;
+		NewAction->GetRepState(Entry);
+		ActionList.MarkItemDirty(Entry);
 
 		// if an Action shall be autostarted but can't yet start,
 		// perhaps there is something wrong design wise hence the ensure
@@ -113,11 +305,274 @@ void USActionComponent::RemoveAction(USAction* ActionToRemove)
 		return;
 	}
 
-	Actions.Remove(ActionToRemove);
+	if (Actions.Remove(ActionToRemove) > 0)
+	{
+		RemoveFromIndex(ActionToRemove);
+
+		// Server only, clients remove their copy when the entry goes away (OnActionEntryRemoved)
+		int32 RemovedIndex = ActionToRemove->ActionListIndex;
+		if (ActionList.Items.IsValidIndex(RemovedIndex) && ActionList.Items[RemovedIndex].Action == ActionToRemove)
+		{
+			// Order doesn't matter to the fast array, move the last entry into the freed slot
+			ActionList.Items.RemoveAtSwap(RemovedIndex, 1, false);
+			if (ActionList.Items.IsValidIndex(RemovedIndex))
+			{
+				ActionList.Items[RemovedIndex].Action->ActionListIndex = RemovedIndex;
+			}
+			ActionList.MarkArrayDirty();
+		}
+		ActionToRemove->ActionListIndex = INDEX_NONE;
+
+		// Clients keep their copy out of the pool until its entry is gone, the entry still points at it (see OnActionEntryRemoved)
+		if (GetOwner()->HasAuthority())
+		{
+			ReleaseAction(ActionToRemove);
+		}
+	}
+}
+
+void USActionComponent::MarkActionDirty(USAction* Action)
+{
+	int32 Index = Action->ActionListIndex;
+	if (!ActionList.Items.IsValidIndex(Index) || ActionList.Items[Index].Action != Action)
+	{
+		// Client, or not added (yet)
+		return;
+	}
+
+	FActionListEntry& Entry = ActionList.Items[Index];
+	Action->GetRepState(Entry);
+	ActionList.MarkItemDirty(Entry);
+
+	INC_DWORD_STAT(STAT_ActionListEntriesDirtied);
+}
+
+void USActionComponent::OnActionEntryAdded(FActionListEntry& Entry)
+{
+	// Class not resolved yet, we get a change callback once it is
+	if (Entry.ActionClass == nullptr || Entry.Action)
+	{
+		return;
+	}
+
+	USAction* Action = AcquireAction(Entry.ActionClass);
+	Action->Initialize(this);
+	Entry.Action = Action;
+
+	Actions.Add(Action);
+	AddToIndex(Action);
+
+	// Starts it if it's running on the server
+	Action->ApplyRepState(Entry);
+}
+
+void USActionComponent::OnActionEntryChanged(FActionListEntry& Entry)
+{
+	if (Entry.Action == nullptr)
+	{
+		OnActionEntryAdded(Entry);
+		return;
+	}
+
+	Entry.Action->ApplyRepState(Entry);
+}
+
+void USActionComponent::OnActionEntryRemoved(FActionListEntry& Entry)
+{
+	USAction* Action = Entry.Action;
+	Entry.Action = nullptr;
+
+	if (Action == nullptr)
+	{
+		return;
+	}
+
+	// The server stops effects and removes them in the same frame, only the removal arrives
+	if (Action->IsRunning())
+	{
+		Action->StopAction(Action->RepData.Instigator); // effects remove themselves
+	}
+
+	if (Actions.Contains(Action))
+	{
+		RemoveAction(Action);
+	}
+
+	// Clients pool the copies they created as well
+	if (!Action->IsRunning())
+	{
+		ReleaseAction(Action);
+	}
+}
+
+void FActionListEntry::PreReplicatedRemove(const FActionList& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComp)
+	{
+		InArraySerializer.OwnerComp->OnActionEntryRemoved(*this);
+	}
+}
+
+void FActionListEntry::PostReplicatedAdd(const FActionList& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComp)
+	{
+		InArraySerializer.OwnerComp->OnActionEntryAdded(*this);
+	}
+}
+
+void FActionListEntry::PostReplicatedChange(const FActionList& InArraySerializer)
+{
+	if (InArraySerializer.OwnerComp)
+	{
+		InArraySerializer.OwnerComp->OnActionEntryChanged(*this);
+	}
+}
+
+bool FActionList::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActionListNetDeltaSerialize);
+
+	return FFastArraySerializer::FastArrayDeltaSerialize<FActionListEntry, FActionList>(Items, DeltaParms, *this);
+}
+
+USAction* USActionComponent::AcquireAction(TSubclassOf<USAction> ActionClass)
+{
+	FActionPoolBucket* Pool = ActionPools.Find(ActionClass);
+	// Oldest first. Never hand out an action released less than a net update ago, the stop of its previous use
+	// (and the removal of its ActionList entry) would not have been sent yet. The rest of the pool is younger still.
+	if (Pool && Pool->Actions.Num() > 0 && GetWorld()->TimeSeconds - Pool->Actions[0]->TimeReleased >= GetMinPoolReuseDelay())
+	{
+		USAction* Action = Pool->Actions[0];
+		Pool->Actions.RemoveAt(0, 1, false);
+
+		NumPoolHits++;
+		INC_DWORD_STAT(STAT_ActionPoolHits);
+
+		// Already reset by ReleaseAction
+		return Action;
+	}
+
+	NumPoolMisses++;
+	INC_DWORD_STAT(STAT_ActionPoolMisses);
+
+	return NewObject<USAction>(GetOwner(), ActionClass); // setting Outer to Actor owning Component. Also see USAction::GetWorld() implementation.
+}
+
+float USActionComponent::GetMinPoolReuseDelay() const
+{
+	AActor* MyOwner = GetOwner();
+	return MyOwner->NetUpdateFrequency > 0.0f ? 1.0f / MyOwner->NetUpdateFrequency : 0.0f;
+}
+
+void USActionComponent::ReleaseAction(USAction* Action)
+{
+	if (!Action->bPooled)
+	{
+		return;
+	}
+
+	FActionPoolBucket& Pool = ActionPools.FindOrAdd(Action->GetClass());
+	if (Pool.Actions.Num() < MaxPooledActionsPerClass)
+	{
+		Action->ResetAction();
+		Action->TimeReleased = GetWorld()->TimeSeconds;
+		Pool.Actions.Add(Action);
+	}
+}
+
+void USActionComponent::LogPoolStats(UWorld* World)
+{
+	TMap<UClass*, int32> LiveActions;
+	TMap<UClass*, int32> PooledActions;
+	int32 NumComponents = 0;
+	int32 TotalHits = 0;
+	int32 TotalMisses = 0;
+
+	for (TObjectIterator<USActionComponent> It; It; ++It)
+	{
+		USActionComponent* ActionComp = *It;
+		if (ActionComp->GetWorld() != World || ActionComp->IsTemplate())
+		{
+			continue;
+		}
+
+		NumComponents++;
+		TotalHits += ActionComp->NumPoolHits;
+		TotalMisses += ActionComp->NumPoolMisses;
+
+		for (USAction* Action : ActionComp->Actions)
+		{
+			if (Action)
+			{
+				LiveActions.FindOrAdd(Action->GetClass())++;
+			}
+		}
+
+		for (const auto& Entry : ActionComp->ActionPools)
+		{
+			PooledActions.FindOrAdd(Entry.Key) += Entry.Value.Actions.Num();
+		}
+	}
+
+	TSet<UClass*> Classes;
+	LiveActions.GetKeys(Classes);
+	for (const auto& Entry : PooledActions)
+	{
+		Classes.Add(Entry.Key);
+	}
+
+	for (UClass* ActionClass : Classes)
+	{
+		UE_LOG(LogTemp, Log, TEXT("ActionPool: %s : %i live, %i pooled."), *GetNameSafe(ActionClass), LiveActions.FindRef(ActionClass), PooledActions.FindRef(ActionClass));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ActionPool: %i components, hits: %i, misses: %i."), NumComponents, TotalHits, TotalMisses);
+}
+
+void USActionComponent::AddToIndex(USAction* Action)
+{
+	ActionsByName.FindOrAdd(Action->ActionName).Add(Action);
+	ActionsByClass.FindOrAdd(Action->GetClass()).Add(Action);
+}
+
+void USActionComponent::RemoveFromIndex(USAction* Action)
+{
+	TArray<USAction*, TInlineAllocator<1>>* NamedActions = ActionsByName.Find(Action->ActionName);
+	if (NamedActions)
+	{
+		NamedActions->Remove(Action);
+		if (NamedActions->Num() == 0)
+		{
+			ActionsByName.Remove(Action->ActionName);
+		}
+	}
+
+	TArray<USAction*, TInlineAllocator<1>>* ClassActions = ActionsByClass.Find(Action->GetClass());
+	if (ClassActions)
+	{
+		ClassActions->Remove(Action);
+		if (ClassActions->Num() == 0)
+		{
+			ActionsByClass.Remove(Action->GetClass());
+		}
+	}
 }
 
 USAction* USActionComponent::GetAction(TSubclassOf<USAction> ActionClass) const
 {
+	if (ActionClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	const TArray<USAction*, TInlineAllocator<1>>* ClassActions = ActionsByClass.Find(ActionClass);
+	if (ClassActions)
+	{
+		return (*ClassActions)[0];
+	}
+
+	// Asking for a base class
 	for (USAction* Action : Actions)
 	{
 		if (Action && Action->IsA(ActionClass))
@@ -148,42 +603,46 @@ bool USActionComponent::StartActionByName(AActor* Instigator, FName ActionName)
 		// This part isn't counted either, it stops at the bracket above.
 	*/
 
-	for (USAction* Action : Actions)
+	// Hash lookup instead of comparing the name of every action, monsters can be granted quite a few of them
+	TArray<USAction*, TInlineAllocator<1>>* NamedActions = ActionsByName.Find(ActionName);
+	if (NamedActions == nullptr)
+	{
+		return false;
+	}
+
+	for (USAction* Action : *NamedActions)
 	{
-		if (Action && Action->ActionName == ActionName)
+		if (!Action->CanStart(Instigator))
 		{
-			if (!Action->CanStart(Instigator))
-			{
-				FString FailedMsg = FString::Printf(TEXT("Failed to run: %s"), *ActionName.ToString());
-				GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, FailedMsg);
-				continue; // although unlikely there may be another Action in Actions TArray with the same name which would potentially execute hence we don't immediately exit/return from the for loop.
-			}
+			FString FailedMsg = FString::Printf(TEXT("Failed to run: %s"), *ActionName.ToString());
+			GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, FailedMsg);
+			continue; // although unlikely there may be another Action in Actions TArray with the same name which would potentially execute hence we don't immediately exit/return from the for loop.
+		}
 
-			// Is Client? - Otherwise infinite loop if called from server! since ServerStartAction_Implementation would call StartActionByName again.
-			if (!GetOwner()->HasAuthority())
-			{
-				// Question : Why is the following line executed (indeed) on the server despite being called from a client?
-				// 
-				// Answer : Since the SActionComponent is owned by a PlayerCharacter (SCharacter),
-				// which in turn is owned by a PlayerController which in turn is also owned by a connection
-				// the RPC invoked from client will indeed execute/run on the server.
-				// For further details read about Ownership here: https://docs.unrealengine.com/4.27/en-US/InteractiveExperiences/Networking/Actors/OwningConnections/
-				// as well as about RPCs here : https://docs.unrealengine.com/4.27/en-US/InteractiveExperiences/Networking/Actors/RPCs/
-				// Make sure to check the RPC tables showcased in the 2nd link ("RPC invoked from a client" table for this specific case).
-				// 
-				ServerStartAction(Instigator, ActionName);
-				//
-				// Note/non-working example : calling a server event from an "unowned actor" or "actor Owned by a different client" would not succeed (DROPPED)
-				// since that actor would NOT be owned by a PlayerController (and therefore a connection) 
-				// as explained in the "RPC invoked from a client" table in the 2nd link above.
-			}
+		// Is Client? - Otherwise infinite loop if called from server! since ServerStartAction_Implementation would call StartActionByName again.
+		if (!GetOwner()->HasAuthority())
+		{
+			// Question : Why is the following line executed (indeed) on the server despite being called from a client?
+			// 
+			// Answer : Since the SActionComponent is owned by a PlayerCharacter (SCharacter),
+			// which in turn is owned by a PlayerController which in turn is also owned by a connection
+			// the RPC invoked from client will indeed execute/run on the server.
+			// For further details read about Ownership here: https://docs.unrealengine.com/4.27/en-US/InteractiveExperiences/Networking/Actors/OwningConnections/
+			// as well as about RPCs here : https://docs.unrealengine.com/4.27/en-US/InteractiveExperiences/Networking/Actors/RPCs/
+			// Make sure to check the RPC tables showcased in the 2nd link ("RPC invoked from a client" table for this specific case).
+			// 
+			ServerStartAction(Instigator, ActionName);
+			//
+			// Note/non-working example : calling a server event from an "unowned actor" or "actor Owned by a different client" would not succeed (DROPPED)
+			// since that actor would NOT be owned by a PlayerController (and therefore a connection) 
+			// as explained in the "RPC invoked from a client" table in the 2nd link above.
+		}
 
-			// Bookmark for Unreal Insights
-			TRACE_BOOKMARK(TEXT("StartAction::%s"), *GetNameSafe(Action));
+		// Bookmark for Unreal Insights
+		TRACE_BOOKMARK(TEXT("StartAction::%s"), *GetNameSafe(Action));
 
-			Action->StartAction(Instigator);
-			return true;
-		}
+		Action->StartAction(Instigator);
+		return true;
 	}
 
 	return false;
@@ -191,21 +650,24 @@ bool USActionComponent::StartActionByName(AActor* Instigator, FName ActionName)
 
 bool USActionComponent::StopActionByName(AActor* Instigator, FName ActionName)
 {
-	for (USAction* Action : Actions)
+	TArray<USAction*, TInlineAllocator<1>>* NamedActions = ActionsByName.Find(ActionName);
+	if (NamedActions == nullptr)
 	{
-		if (Action && Action->ActionName == ActionName)
+		return false;
+	}
+
+	for (USAction* Action : *NamedActions)
+	{
+		if (Action->IsRunning())
 		{
-			if (Action->IsRunning())
-			{
-				// is client? then send server RPC to stop action. also see USActionComponent::StartActionByName comments above
-				if (!GetOwner()->HasAuthority())
-				{		
-					ServerStopAction(Instigator, ActionName);
-				}
-
-				Action->StopAction(Instigator); // also stop the action locally so no lag occurs.
-				return true;
+			// is client? then send server RPC to stop action. also see USActionComponent::StartActionByName comments above
+			if (!GetOwner()->HasAuthority())
+			{		
+				ServerStopAction(Instigator, ActionName);
 			}
+
+			Action->StopAction(Instigator); // also stop the action locally so no lag occurs.
+			return true;
 		}
 	}
 
@@ -222,23 +684,9 @@ void USActionComponent::ServerStopAction_Implementation(AActor* Instigator, FNam
 	StopActionByName(Instigator, ActionName);
 }
 
-bool USActionComponent::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
-{
-	bool WroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
-	for (USAction* Action : Actions)
-	{
-		if (Action)
-		{
-			WroteSomething |= Channel->ReplicateSubobject(Action, *Bunch, *RepFlags);
-		}
-	}
-
-	return WroteSomething;
-}
-
 void USActionComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const //function is defined in the ClassName.generated.h
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(USActionComponent, Actions);
+	DOREPLIFETIME(USActionComponent, ActionList);
 }
\ No newline at end of file
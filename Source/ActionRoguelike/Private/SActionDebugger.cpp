@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SActionDebugger.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "SActionComponent.h"
+#include "SAction.h"
+#include "../ActionRoguelike.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("ActionDebugger Draw"), STAT_ActionDebuggerDraw, STATGROUP_STANFORD);
+
+static TAutoConsoleVariable<bool> CVarActionDebug(TEXT("su.ActionDebug"), false, TEXT("Draw actions (running ones in blue) and active tags next to every actor with an action component."), ECVF_Cheat);
+
+TArray<TWeakObjectPtr<USActionComponent>> FActionDebugger::Components;
+
+FDelegateHandle FActionDebugger::DrawHandle;
+
+void FActionDebugger::AddComponent(USActionComponent* ActionComp)
+{
+	Components.AddUnique(ActionComp);
+
+	// Only hooked up while there is something to draw
+	if (!DrawHandle.IsValid())
+	{
+		DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateStatic(&FActionDebugger::Draw));
+	}
+}
+
+void FActionDebugger::RemoveComponent(USActionComponent* ActionComp)
+{
+	Components.RemoveSwap(ActionComp);
+
+	if (Components.Num() == 0 && DrawHandle.IsValid())
+	{
+		UDebugDrawService::Unregister(DrawHandle);
+		DrawHandle.Reset();
+	}
+}
+
+void FActionDebugger::Draw(UCanvas* Canvas, APlayerController* PC)
+{
+	if (!CVarActionDebug.GetValueOnGameThread() || Canvas == nullptr || PC == nullptr)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ActionDebuggerDraw);
+
+	UFont* Font = GEngine->GetSmallFont();
+	float LineHeight = Font->GetMaxCharHeight();
+
+	// PIE runs several worlds (server and clients) in one process, each viewport only draws its own
+	UWorld* World = PC->GetWorld();
+	FString NetPrefix = World->IsNetMode(NM_Client) ? "[CLIENT] " : "[SERVER] ";
+
+	for (const TWeakObjectPtr<USActionComponent>& ActionComp : Components)
+	{
+		AActor* Owner = ActionComp.IsValid() ? ActionComp->GetOwner() : nullptr;
+		if (Owner == nullptr || Owner->GetWorld() != World)
+		{
+			continue;
+		}
+
+		// Behind the camera
+		FVector ScreenLocation = Canvas->Project(Owner->GetActorLocation());
+		if (ScreenLocation.Z <= 0.0f)
+		{
+			continue;
+		}
+
+		float X = ScreenLocation.X;
+		float Y = ScreenLocation.Y;
+
+		Canvas->SetDrawColor(FColor::White);
+		Canvas->DrawText(Font, NetPrefix + GetNameSafe(Owner) + " : " + ActionComp->ActiveGameplayTags.ToStringSimple(), X, Y);
+		Y += LineHeight;
+
+		for (USAction* Action : ActionComp->GetActions())
+		{
+			if (Action)
+			{
+				Canvas->SetDrawColor(Action->IsRunning() ? FColor::Blue : FColor::White);
+				Canvas->DrawText(Font, Action->ActionName.ToString(), X, Y);
+				Y += LineHeight;
+			}
+		}
+	}
+}
+
+#endif
@@ -4,62 +4,124 @@
 #include "SActionEffect.h"
 #include "SActionComponent.h"
 #include "GameFramework/GameStateBase.h"
+#include "SEffectSchedulerSubsystem.h"
 
 USActionEffect::USActionEffect()
 {
 	bAutoStart = true;
+
+	StackingPolicy = EEffectStackingPolicy::Independent;
+	MaxStacks = 1;
+	StackCount = 0;
+	SchedulerIndex = INDEX_NONE;
 }
 
 void USActionEffect::StartAction_Implementation(AActor* Instigator)
 {
+	// Before Super, which sends our state to clients
+	if (GetOwningComponent()->GetOwnerRole() == ROLE_Authority)
+	{
+		StackCount = 1;
+	}
+
 	Super::StartAction_Implementation(Instigator);
 
-	if (Duration > 0.0f)
+	// Duration and Period are run by the scheduler, which calls StopAction/ExecutePeriodicEffect with the Instigator in RepData
+	if (Duration > 0.0f || Period > 0.0f)
 	{
-		FTimerDelegate Delegate;
-		Delegate.BindUFunction(this, "StopAction", Instigator);
+		GetWorld()->GetSubsystem<USEffectSchedulerSubsystem>()->AddEffect(this, Duration, Period);
+	}
+}
 
-		GetWorld()->GetTimerManager().SetTimer(DurationHandle, Delegate, Duration, false);
+void USActionEffect::StopAction_Implementation(AActor* Instigator)
+{
+	// With two separate timers the duration could elapse just before the period fired for the last time (Duration=3, Period=1 : only 2 ticks),
+	// StopAction used to check the period timer and run the final tick itself. The scheduler always runs a tick due at the end before stopping.
+	GetWorld()->GetSubsystem<USEffectSchedulerSubsystem>()->RemoveEffect(this);
+
+	Super::StopAction_Implementation(Instigator);
+
+	USActionComponent* Comp = GetOwningComponent();
+	if (Comp)
+	{
+		Comp->RemoveAction(this);
 	}
 
-	if (Period > 0.0f)
+}
+
+void USActionEffect::Reapply(AActor* Instigator)
+{
+	if (StackingPolicy == EEffectStackingPolicy::Ignore)
 	{
-		FTimerDelegate Delegate;
-		Delegate.BindUFunction(this, "ExecutePeriodicEffect", Instigator);
+		return;
+	}
 
-		GetWorld()->GetTimerManager().SetTimer(PeriodHandle, Delegate, Period, true); // looping timer
+	if (StackingPolicy == EEffectStackingPolicy::Stack && StackCount < FMath::Clamp(MaxStacks, 1, 255))
+	{
+		StackCount++;
+		GetOwningComponent()->OnEffectStacksChanged.Broadcast(GetOwningComponent(), this);
 	}
 
+	// Period keeps its rhythm and original instigator, only the end moves. TimeStarted replicates the new end to clients (GetTimeRemaining).
+	GetWorld()->GetSubsystem<USEffectSchedulerSubsystem>()->RefreshDuration(this, Duration);
+	TimeStarted = GetWorld()->TimeSeconds;
+
+	GetOwningComponent()->MarkActionDirty(this);
 }
 
-void USActionEffect::StopAction_Implementation(AActor* Instigator)
+void USActionEffect::GetRepState(FActionListEntry& Entry) const
+{
+	Super::GetRepState(Entry);
+
+	Entry.StackCount = StackCount;
+}
+
+void USActionEffect::ApplyRepState(const FActionListEntry& Entry)
 {
-	// Issue: DurationTimer might fire just a little bit before PeriodTimer could fire for one last time.
-	
-	// Example : DurationTimer=3 sec, PeriodTimer=1 sec (looping). 
-	// PeriodTimer fires 2 times successfully but just before executing a 3rd (and final) time
-	// DurationTimer elapses calling StopAction, thereby cancelling both timers.
-	
-	// Solution:
-	// We want to make sure that Period Timer gets to execute before cancelling both timers below.
-	// We also need to do this before calling Super::StopAction_Implementation 
-	// because that would remove Grants/Blocked tags potentially affecting the functionality of the ActionEffect.
-	if (GetWorld()->GetTimerManager().GetTimerRemaining(PeriodHandle) < KINDA_SMALL_NUMBER)
+	bool bStacksChanged = Entry.StackCount != StackCount;
+	StackCount = Entry.StackCount;
+
+	bool bWasRunning = IsRunning();
+	float OldTimeStarted = TimeStarted;
+
+	Super::ApplyRepState(Entry);
+
+	// Reapplied on the server (Refresh/Stack moved TimeStarted). Our own scheduler would still stop the effect at the old end,
+	// follow the server's deadline instead. GetTimeRemaining works in server time, so this also holds up with clock offset.
+	if (bWasRunning && IsRunning() && TimeStarted != OldTimeStarted && Duration > 0.0f)
 	{
-		ExecutePeriodicEffect(Instigator);
+		GetWorld()->GetSubsystem<USEffectSchedulerSubsystem>()->RefreshDuration(this, FMath::Max(GetTimeRemaining(), KINDA_SMALL_NUMBER));
 	}
 
-	Super::StopAction_Implementation(Instigator);
-
-	GetWorld()->GetTimerManager().ClearTimer(PeriodHandle);
-	GetWorld()->GetTimerManager().ClearTimer(DurationHandle);
+	if (bStacksChanged)
+	{
+		GetOwningComponent()->OnEffectStacksChanged.Broadcast(GetOwningComponent(), this);
+	}
+}
 
-	USActionComponent* Comp = GetOwningComponent();
-	if (Comp)
+void USActionEffect::ExecutePeriodicTick()
+{
+	// Same total as StackCount separate instances ticking together. Stop if a tick ended the effect (e.g. killed the owner).
+	int32 NumTicks = FMath::Max<int32>(StackCount, 1);
+	for (int32 i = 0; i < NumTicks && IsRunning(); i++)
 	{
-		Comp->RemoveAction(this);
+		ExecutePeriodicEffect(RepData.Instigator);
 	}
+}
 
+int32 USActionEffect::GetStackCount() const
+{
+	return StackCount;
+}
+
+void USActionEffect::ResetAction_Implementation()
+{
+	Super::ResetAction_Implementation();
+
+	StackCount = 0;
+
+	// Removed by StopAction already, just in case we were removed some other way
+	GetWorld()->GetSubsystem<USEffectSchedulerSubsystem>()->RemoveEffect(this);
 }
 
 float USActionEffect::GetTimeRemaining() const
@@ -79,4 +141,4 @@ float USActionEffect::GetTimeRemaining() const
 void USActionEffect::ExecutePeriodicEffect_Implementation(AActor* InstigatorActor)
 {
 
-}
\ No newline at end of file
+}
@@ -14,6 +14,9 @@ USActionEffect_Thorns::USActionEffect_Thorns()
 
 	Duration = 0.0f;
 	Period = 0.0f;
+
+	// Nothing but the health binding changes while running and StopAction removes that, the base ResetAction covers the rest
+	bPooled = true;
 }
 
 
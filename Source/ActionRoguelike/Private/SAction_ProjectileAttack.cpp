@@ -4,6 +4,7 @@
 #include "SAction_ProjectileAttack.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
+#include "SProjectilePoolSubsystem.h"
 
 USAction_ProjectileAttack::USAction_ProjectileAttack()
 {
@@ -36,10 +37,6 @@ void USAction_ProjectileAttack::AttackDelay_Elapsed(ACharacter* InstigatorCharac
 	{
 		FVector HandLocation = InstigatorCharacter->GetMesh()->GetSocketLocation(HandSocketName);
 
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.Instigator = InstigatorCharacter;
-
 		FHitResult Hit;
 		FVector TraceStart = InstigatorCharacter->GetPawnViewLocation(); // conveniently overriden function in SCharacter from earlier lecture
 		// endpoint far into the look-at distance (not too far, still adjust somewhat towards crosshair on a miss)
@@ -71,7 +68,9 @@ void USAction_ProjectileAttack::AttackDelay_Elapsed(ACharacter* InstigatorCharac
 		}
 
 		FTransform SpawnTM = FTransform(ProjRotation, HandLocation);
-		GetWorld()->SpawnActor<AActor>(ProjectileClass, SpawnTM, SpawnParams);
+		// Reuses a pooled projectile when available (spawns with AlwaysSpawn + instigator otherwise)
+		USProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<USProjectilePoolSubsystem>();
+		ProjectilePool->AcquireProjectile(ProjectileClass, SpawnTM, InstigatorCharacter);
 	}
 
 	StopAction(InstigatorCharacter); // Remeber to call the non _Implementation function
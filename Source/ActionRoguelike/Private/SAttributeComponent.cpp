@@ -24,6 +24,19 @@ bool USAttributeComponent::Kill(AActor* InstigatorActor)
 	return ApplyHealthChange(InstigatorActor, -GetHealthMax()); // -(minus) sign so that this becomes damage and not healing
 }
 
+void USAttributeComponent::ResetAttributes()
+{
+	if (!ensure(GetOwner()->HasAuthority()))
+	{
+		return;
+	}
+
+	// Set directly instead of ApplyHealthChange, a recycled actor is not 'healed' and nobody should react to it.
+	// Both values replicate to clients.
+	Health = HealthMax;
+	Rage = 0.0f;
+}
+
 bool USAttributeComponent::IsAlive() const
 {
 	return (Health > 0.0f);
@@ -24,6 +24,13 @@ void ASDashProjectile::BeginPlay()
 	GetWorldTimerManager().SetTimer(TimerHandle_DelayedDetonate, this, &ASDashProjectile::Explode, DetonateDelay);
 }
 
+void ASDashProjectile::Launch()
+{
+	Super::Launch();
+
+	GetWorldTimerManager().SetTimer(TimerHandle_DelayedDetonate, this, &ASDashProjectile::Explode, DetonateDelay);
+}
+
 // Base class using BlueprintNativeEvent, we must reimplement the _Implementation not the plain Explode()
 void ASDashProjectile::Explode_Implementation()
 {
@@ -40,7 +47,7 @@ void ASDashProjectile::Explode_Implementation()
 	FTimerHandle TimerHandle_DelayedTeleport; // local variable 2nd TimerHandle - not exposed on header as we never want to cancel this timer hence a reference would not be needed
 	GetWorldTimerManager().SetTimer(TimerHandle_DelayedTeleport, this, &ASDashProjectile::TeleportInstigator, TeleportDelay);
 
-	// Skip base implementation as it will destroy actor
+	// Skip base implementation as it will return us to the pool
 	// and cancel our second timer (TimerHandle_DelayedTeleport) 
 	// as a result TeleportInstigator() will never get called
 	//Super::Explode_Implementation();
@@ -55,4 +62,6 @@ void ASDashProjectile::TeleportInstigator()
 		// Keep instigator rotation or it may end up jarring
 		ActorToTeleport->TeleportTo(GetActorLocation(), ActorToTeleport->GetActorRotation(), false, false);
 	}
+
+	ReturnToPool();
 }
\ No newline at end of file
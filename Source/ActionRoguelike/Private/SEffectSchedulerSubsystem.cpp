@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SEffectSchedulerSubsystem.h"
+#include "SActionEffect.h"
+#include "../ActionRoguelike.h"
+
+DECLARE_CYCLE_STAT(TEXT("EffectScheduler"), STAT_EffectScheduler, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scheduled Effects"), STAT_ScheduledEffects, STATGROUP_STANFORD);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effect Periodic Ticks"), STAT_EffectPeriodicTicks, STATGROUP_STANFORD);
+
+void USEffectSchedulerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NextDueTime = MAX_flt;
+
+	// After actors ticked, same as the timers we replace (and before replication sends their results)
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &USEffectSchedulerSubsystem::OnWorldPostActorTick);
+}
+
+void USEffectSchedulerSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	for (USActionEffect* Effect : Effects)
+	{
+		if (Effect)
+		{
+			Effect->SchedulerIndex = INDEX_NONE;
+		}
+	}
+	Effects.Empty();
+	EndTimes.Empty();
+	NextPeriodTimes.Empty();
+	Periods.Empty();
+	StartTimes.Empty();
+	NumTicks.Empty();
+
+	Super::Deinitialize();
+}
+
+void USEffectSchedulerSubsystem::AddEffect(USActionEffect* Effect, float Duration, float Period)
+{
+	if (!ensure(Effect) || IsScheduled(Effect))
+	{
+		return;
+	}
+
+	float Now = GetWorld()->GetTimeSeconds();
+
+	Effect->SchedulerIndex = Effects.Add(Effect);
+	EndTimes.Add(Duration > 0.0f ? Now + Duration : MAX_flt);
+	NextPeriodTimes.Add(Period > 0.0f ? Now + Period : MAX_flt);
+	Periods.Add(Period);
+	StartTimes.Add(Now);
+	NumTicks.Add(0);
+
+	NextDueTime = FMath::Min3(NextDueTime, EndTimes.Last(), NextPeriodTimes.Last());
+
+	INC_DWORD_STAT(STAT_ScheduledEffects);
+}
+
+void USEffectSchedulerSubsystem::RefreshDuration(USActionEffect* Effect, float Duration)
+{
+	if (!IsScheduled(Effect) || Duration <= 0.0f)
+	{
+		return;
+	}
+
+	float& EndTime = EndTimes[Effect->SchedulerIndex];
+	EndTime = GetWorld()->GetTimeSeconds() + Duration;
+
+	NextDueTime = FMath::Min(NextDueTime, EndTime);
+}
+
+void USEffectSchedulerSubsystem::RemoveEffect(USActionEffect* Effect)
+{
+	if (!IsScheduled(Effect))
+	{
+		return;
+	}
+
+	// O(1) removal : move the last effect into the freed slot, same for all arrays
+	int32 RemovedIndex = Effect->SchedulerIndex;
+	Effects.RemoveAtSwap(RemovedIndex, 1, false);
+	EndTimes.RemoveAtSwap(RemovedIndex, 1, false);
+	NextPeriodTimes.RemoveAtSwap(RemovedIndex, 1, false);
+	Periods.RemoveAtSwap(RemovedIndex, 1, false);
+	StartTimes.RemoveAtSwap(RemovedIndex, 1, false);
+	NumTicks.RemoveAtSwap(RemovedIndex, 1, false);
+	if (Effects.IsValidIndex(RemovedIndex))
+	{
+		Effects[RemovedIndex]->SchedulerIndex = RemovedIndex;
+	}
+
+	Effect->SchedulerIndex = INDEX_NONE;
+
+	DEC_DWORD_STAT(STAT_ScheduledEffects);
+}
+
+bool USEffectSchedulerSubsystem::IsScheduled(const USActionEffect* Effect) const
+{
+	return Effect && Effects.IsValidIndex(Effect->SchedulerIndex) && Effects[Effect->SchedulerIndex] == Effect;
+}
+
+void USEffectSchedulerSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Fires for every world (PIE)
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	float Now = World->GetTimeSeconds();
+	if (Now < NextDueTime)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_EffectScheduler);
+
+	ProcessDueEffects(Now);
+	UpdateNextDueTime();
+}
+
+void USEffectSchedulerSubsystem::ProcessDueEffects(float Now)
+{
+	// Collect first : periodic effects apply damage, which can kill the owner and stop (remove) any number of other effects
+	DueEffects.Reset();
+	for (int32 i = 0; i < Effects.Num(); i++)
+	{
+		if (EndTimes[i] <= Now || NextPeriodTimes[i] <= Now)
+		{
+			DueEffects.Add(Effects[i]);
+		}
+	}
+
+	for (USActionEffect* Effect : DueEffects)
+	{
+		// Every period that elapsed by now, but none after the end. A tick landing on the end still happens (ticks before stopping),
+		// with the same KINDA_SMALL_NUMBER tolerance the old timer based StopAction used : the tick time and the end are computed
+		// separately, at large world times the last tick can come out a float step after the end (Duration=3, Period=1 : only 2 ticks).
+		while (IsScheduled(Effect))
+		{
+			int32 Index = Effect->SchedulerIndex;
+			bool bEnded = EndTimes[Index] <= Now;
+			if (bEnded ? NextPeriodTimes[Index] > EndTimes[Index] + KINDA_SMALL_NUMBER : NextPeriodTimes[Index] > Now)
+			{
+				break;
+			}
+
+			NumTicks[Index]++;
+			NextPeriodTimes[Index] = StartTimes[Index] + (NumTicks[Index] + 1) * Periods[Index];
+
+			INC_DWORD_STAT(STAT_EffectPeriodicTicks);
+			Effect->ExecutePeriodicTick();
+		}
+
+		if (IsScheduled(Effect) && EndTimes[Effect->SchedulerIndex] <= Now)
+		{
+			Effect->StopAction(Effect->RepData.Instigator);
+
+			// StopAction removes it already, unless a Blueprint override forgot to call the parent
+			RemoveEffect(Effect);
+		}
+	}
+
+	DueEffects.Reset();
+}
+
+void USEffectSchedulerSubsystem::UpdateNextDueTime()
+{
+	NextDueTime = MAX_flt;
+	for (int32 i = 0; i < Effects.Num(); i++)
+	{
+		NextDueTime = FMath::Min3(NextDueTime, EndTimes[i], NextPeriodTimes[i]);
+	}
+}
@@ -19,9 +19,48 @@
 #include "../ActionRoguelike.h"
 #include "SActionComponent.h"
 #include "Engine/AssetManager.h"
+#include "AI/SBotRegistrySubsystem.h"
+#include "SMonsterAssetCache.h"
+#include "AI/SBotPoolSubsystem.h"
+#include "SProjectilePoolSubsystem.h"
+#include "SPlacementGrid.h"
+#include "AI/SSpawnLocationCache.h"
+#include "SSoakBenchmarkSubsystem.h"
+#include "SRandomSubsystem.h"
+#include "SSaveGameFile.h"
+#include "SSaveGameRegistrySubsystem.h"
+#include "Async/Async.h"
+#include "SSaveBenchmarkActor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+
+DECLARE_CYCLE_STAT(TEXT("ProcessBotSpawnQueue"), STAT_ProcessBotSpawnQueue, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("PlacePowerups"), STAT_PlacePowerups, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("ProcessPowerupSpawnQueue"), STAT_ProcessPowerupSpawnQueue, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Snapshot"), STAT_SaveGameSnapshot, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Snapshot (ms)"), STAT_SaveGameSnapshotMs, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Serialize (ms)"), STAT_SaveGameSerializeMs, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Compress (ms)"), STAT_SaveGameCompressMs, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Write (ms)"), STAT_SaveGameWriteMs, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveGame Bytes Written"), STAT_SaveGameBytes, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveGame Actors Serialized"), STAT_SaveGameActorsSerialized, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Player Records"), STAT_SavePlayerRecords, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Autosave Slice (ms)"), STAT_AutosaveSliceMs, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Autosave Frames"), STAT_AutosaveFrames, STATGROUP_STANFORD);
+DECLARE_CYCLE_STAT(TEXT("SaveGame Restore"), STAT_SaveGameRestore, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveGame Actors Restored"), STAT_SaveGameActorsRestored, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Actors Restored per ms"), STAT_SaveGameActorsRestoredPerMs, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SaveGame Load (ms)"), STAT_SaveGameLoadMs, STATGROUP_STANFORD);
 
 static TAutoConsoleVariable<bool> CVarSpawnBots(TEXT("su.SpawnBots"), true, TEXT("Enable spawning of bots via timer."), ECVF_Cheat);
 
+static TAutoConsoleVariable<int32> CVarRandomSeed(TEXT("su.RandomSeed"), 0, TEXT("Match seed for gameplay random streams, applied on the next InitGame (0 = use ?Seed= option or GameMode default)."), ECVF_Cheat);
+
+static TAutoConsoleVariable<bool> CVarAutosave(TEXT("su.Autosave"), true, TEXT("Enable autosaves (timer, wave cleared, chest opened)."), ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarForceBotCount(TEXT("su.ForceBotCount"), 0, TEXT("Keep this many bots alive, ignoring DifficultyCurve, spawn points and MaxWaveSize (0 = disabled). Used by the soak benchmark."), ECVF_Cheat);
+
 ASGameModeBase::ASGameModeBase()
 {
 	SpawnTimerInterval = 2.0f;
@@ -30,10 +69,35 @@ ASGameModeBase::ASGameModeBase()
 
 	DesiredPowerupCount = 10;
 	RequiredPowerupDistance = 2000;
+	MaxPowerupSpawnsPerFrame = 50;
+
+	RandomSeed = 0;
+
+	SpawnPointsPerSecond = 2.5f; // one 5 point minion every 2 seconds, same pace as the old fixed timer
+	MaxSpawnPoints = 50.0f;
+	MaxWaveSize = 5;
+	MaxBotSpawnsPerFrame = 1;
+	AvailableSpawnPoints = 0.0f;
+	NrOfBotsLoading = 0;
+	SpawnLocationRefreshDistance = 1500.0f;
 
 	PlayerStateClass = ASPlayerState::StaticClass(); // alternative way to assign default GameMode classes without assigning them from Editor via GameMode inherited Blueprint.
 
 	SlotName = "SaveGame01";
+
+	bSaveInFlight = false;
+	bSaveQueued = false;
+	bFullSaveRequired = true;
+	bRestoreSavedActors = false;
+	bSaveGameLoading = false;
+	bSavePlayersLoading = false;
+	bHasEndedPlay = false;
+	bActorSaveInProgress = false;
+	NumActorsSerialized = 0;
+	NumSaveFrames = 0;
+
+	AutosaveInterval = 120.0f;
+	AutosaveFrameBudgetMs = 1.0f;
 }
 
 void ASGameModeBase::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
@@ -46,7 +110,38 @@ void ASGameModeBase::InitGame(const FString& MapName, const FString& Options, FS
 		SlotName = SelectedSaveSlot;
 	}
 
-	LoadSaveGame(); // load save game as early as possible
+	// Fixed seed makes spawn and combat sequences reproducible (e.g. for benchmarks). URL option wins over cvar, cvar over GameMode default.
+	int32 Seed = CVarRandomSeed.GetValueOnGameThread();
+	if (Seed == 0)
+	{
+		Seed = RandomSeed;
+	}
+	Seed = UGameplayStatics::GetIntOption(Options, "Seed", Seed);
+
+	USRandomSubsystem* Random = GetWorld()->GetSubsystem<USRandomSubsystem>();
+	if (Seed != 0)
+	{
+		Random->SetMatchSeed(Seed);
+	}
+	UE_LOG(LogTemp, Log, TEXT("Match seed: %i (replay with ?Seed=%i)"), Random->GetMatchSeed(), Random->GetMatchSeed());
+
+	// Compile the MonsterTable and start preloading every monster it references, long before the first wave needs them
+	RebuildMonsterCatalog();
+
+#if WITH_EDITOR
+	// Pick up edits to the table while playing in editor without restarting PIE
+	if (MonsterTable)
+	{
+		MonsterTableChangedHandle = MonsterTable->OnDataTableChanged().AddUObject(this, &ASGameModeBase::RebuildMonsterCatalog);
+	}
+#endif
+
+	// Keeps incremental saves in sync with actors that come and go during the match
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	SaveActorRegisteredHandle = SaveRegistry->OnActorRegistered.AddUObject(this, &ASGameModeBase::OnSaveActorRegistered);
+	SaveActorUnregisteredHandle = SaveRegistry->OnActorUnregistered.AddUObject(this, &ASGameModeBase::OnSaveActorUnregistered);
+
+	LoadSaveGame(); // start reading the save game as early as possible, it finishes on a worker thread while the map initializes
 }
 
 void ASGameModeBase::StartPlay()
@@ -54,6 +149,43 @@ void ASGameModeBase::StartPlay()
 
 	Super::StartPlay(); // calls BeginPlay on actors.
 
+	// All level actors have registered with the save registry by now. If the save is still being read, FinishSaveGameLoad restores them instead.
+	RestoreSavedActors();
+
+	// Only does something when launched with -SaveBenchmark=1000+10000+50000
+	FString SaveBenchmarkSizes;
+	if (FParse::Value(FCommandLine::Get(), TEXT("SaveBenchmark="), SaveBenchmarkSizes))
+	{
+		TArray<FString> SizeStrings;
+		SaveBenchmarkSizes.ParseIntoArray(SizeStrings, TEXT("+"));
+
+		TArray<int32> Sizes;
+		for (const FString& SizeString : SizeStrings)
+		{
+			Sizes.Add(FCString::Atoi(*SizeString));
+		}
+
+		RunSaveBenchmarks(Sizes);
+
+		if (FApp::IsUnattended())
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+
+	// Start looking for spawn locations right away, ready by the time the first wave is planned
+	USSpawnLocationCache* SpawnLocationCache = GetWorld()->GetSubsystem<USSpawnLocationCache>();
+	SpawnLocationCache->Setup(SpawnBotQuery, this, SpawnLocationRefreshDistance, MaxWaveSize);
+
+	// Only does something when launched with -SoakBots=N
+	USSoakBenchmarkSubsystem* SoakBenchmark = GetWorld()->GetSubsystem<USSoakBenchmarkSubsystem>();
+	SoakBenchmark->StartFromCommandLine();
+
+	if (AutosaveInterval > 0.0f)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_Autosave, this, &ASGameModeBase::RequestAutosave, AutosaveInterval, true);
+	}
+
 	// looping timer for spawning bots
 	GetWorldTimerManager().SetTimer(TimerHandle_SpawnBots, this, &ASGameModeBase::SpawnBotTimerElapsed, SpawnTimerInterval, true);
 
@@ -70,13 +202,189 @@ void ASGameModeBase::StartPlay()
 
 }
 
+void ASGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	bHasEndedPlay = true;
+
+	// Make sure the last save actually made it to disk. Its OnSaveGameWriteFinished still arrives later and is ignored (bHasEndedPlay).
+	if (PendingSaveWrite.IsValid())
+	{
+		PendingSaveWrite.Wait();
+	}
+
+	// The follow-up save OnSaveGameWriteFinished would have started. Write what CurrentSaveGame holds right here instead,
+	// without serializing the actors again : they may have ended play already. Dropped while still loading, that would overwrite the slot with a partial save.
+	if (bSaveQueued)
+	{
+		bSaveQueued = false;
+
+		if (bSaveGameLoading)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SaveGame: Dropped queued save of slot '%s', map ended before it was loaded."), *SlotName);
+		}
+		else if (CurrentSaveGame)
+		{
+			FSaveGameSnapshot Snapshot;
+			FSaveGameFile::MakeSnapshot(CurrentSaveGame, Snapshot);
+
+			FSaveGameWriteResult Result;
+			FSaveGameFile::Write(Snapshot, SlotName, 0, Result);
+
+			UE_LOG(LogTemp, Log, TEXT("SaveGame: Wrote queued save of slot '%s' on EndPlay (%s)."), *SlotName, Result.bSuccess ? TEXT("ok") : TEXT("failed"));
+		}
+	}
+
+	// Map ended before the read finished (e.g. quick travel). Waiting only covers the worker, the game thread callbacks
+	// it already queued still run after this and bail out on bHasEndedPlay, nothing gets applied to a world being torn down.
+	if (PendingSaveLoad.IsValid())
+	{
+		PendingSaveLoad.Wait();
+	}
+
+#if WITH_EDITOR
+	if (MonsterTable)
+	{
+		MonsterTable->OnDataTableChanged().Remove(MonsterTableChangedHandle);
+	}
+#endif
+
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->OnActorRegistered.Remove(SaveActorRegisteredHandle);
+		SaveRegistry->OnActorUnregistered.Remove(SaveActorUnregisteredHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASGameModeBase::RebuildMonsterCatalog()
+{
+	MonsterCatalog.Build(MonsterTable);
+
+	PreloadMonsterAssets();
+}
+
+void ASGameModeBase::PreloadMonsterAssets()
+{
+	USMonsterAssetCache* MonsterCache = GetWorld()->GetSubsystem<USMonsterAssetCache>();
+	if (!ensure(MonsterCache))
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> MonsterIds;
+	for (const FMonsterInfoRow* Row : MonsterCatalog.GetRows())
+	{
+		MonsterIds.AddUnique(Row->MonsterId);
+	}
+
+	// Dedicated servers never display anything, skip the cosmetic bundles there
+	TArray<FName> Bundles = MonsterPreloadBundles;
+	if (!IsRunningDedicatedServer())
+	{
+		Bundles.Append(MonsterPreloadCosmeticBundles);
+	}
+
+	if (!MonsterCache->OnMonsterReady.IsBoundToObject(this))
+	{
+		MonsterCache->OnMonsterReady.AddUObject(this, &ASGameModeBase::OnMonsterPreloaded);
+	}
+
+	MonsterCache->PreloadMonsters(MonsterIds, Bundles);
+}
+
+void ASGameModeBase::OnMonsterPreloaded(USMonsterData* MonsterData)
+{
+	// Fill the bot pool ahead of the first waves
+	USBotPoolSubsystem* BotPool = GetWorld()->GetSubsystem<USBotPoolSubsystem>();
+	if (BotPool && MonsterData->PoolWarmUpCount > 0)
+	{
+		BotPool->RequestWarmUp(MonsterData->MonsterClass, MonsterData->PoolWarmUpCount);
+	}
+}
+
+void ASGameModeBase::MonsterCacheStats()
+{
+	USMonsterAssetCache* MonsterCache = GetWorld()->GetSubsystem<USMonsterAssetCache>();
+	if (MonsterCache)
+	{
+		MonsterCache->LogStats();
+	}
+}
+
+void ASGameModeBase::BotPoolStats()
+{
+	USBotPoolSubsystem* BotPool = GetWorld()->GetSubsystem<USBotPoolSubsystem>();
+	if (BotPool)
+	{
+		BotPool->LogStats();
+	}
+}
+
+void ASGameModeBase::SpawnLocationCacheStats()
+{
+	USSpawnLocationCache* SpawnLocationCache = GetWorld()->GetSubsystem<USSpawnLocationCache>();
+	if (SpawnLocationCache)
+	{
+		SpawnLocationCache->LogStats();
+	}
+}
+
+void ASGameModeBase::SaveRegistryStats()
+{
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->LogStats();
+	}
+}
+
+void ASGameModeBase::ActionPoolStats()
+{
+	USActionComponent::LogPoolStats(GetWorld());
+}
+
+void ASGameModeBase::ActionLookupBenchmark(int32 NumActions)
+{
+	USActionComponent::LogLookupBenchmark(this, NumActions);
+}
+
+void ASGameModeBase::SaveBenchmark(int32 NumActors)
+{
+	RunSaveBenchmarks({ NumActors });
+}
+
+void ASGameModeBase::SaveGameFormatStats()
+{
+	FSaveGameFile::LogFormatComparison(CurrentSaveGame);
+}
+
+void ASGameModeBase::ProjectilePoolStats()
+{
+	USProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<USProjectilePoolSubsystem>();
+	if (ProjectilePool)
+	{
+		ProjectilePool->LogStats();
+	}
+}
+
 void ASGameModeBase::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
 {	
 	// Calling Before Super:: so we set variables before 'beginplayingstate' is called in PlayerController (which is where we instantiate UI in PlayerController_BP)
+	// Only applies this player's own record, also for players joining mid match
 	ASPlayerState* PS = NewPlayer->GetPlayerState<ASPlayerState>();
 	if (ensure(PS))
 	{
-		PS->LoadPlayerState(CurrentSaveGame);
+		if (bSavePlayersLoading)
+		{
+			// Don't hold up the player (or the boot) on the file, credits show up through OnCreditsChanged once the records are read
+			PlayersAwaitingSaveGame.Add(PS);
+		}
+		else
+		{
+			PS->LoadPlayerState(CurrentSaveGame);
+		}
 	}
 
 	// this eventually will call APlayerController::BeginPlayingState 
@@ -87,10 +395,17 @@ void ASGameModeBase::HandleStartingNewPlayer_Implementation(APlayerController* N
 
 void ASGameModeBase::KillAll()
 {
-	for (TActorIterator<ASAICharacter> It(GetWorld()); It; ++It) // see comments below in SpawnBotTimerElapsed() for alternate implementations
+	USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+	if (!ensure(BotRegistry))
 	{
-		ASAICharacter* Bot = *It;
+		return;
+	}
 
+	// Killing a bot unregisters it from the registry (see ASAICharacter::OnHealthChanged) which modifies AliveBots.
+	// Hence the need to iterate over a copy, similar to USActionComponent::EndPlay.
+	TArray<ASAICharacter*> BotsCopy = BotRegistry->GetAliveBots();
+	for (ASAICharacter* Bot : BotsCopy)
+	{
 		USAttributeComponent* AttributeComp = USAttributeComponent::GetAttributes(Bot);
 		if (ensure(AttributeComp) && AttributeComp->IsAlive())
 		{
@@ -108,22 +423,23 @@ void ASGameModeBase::SpawnBotTimerElapsed()
 		return;
 	}
 
-	int32 NrOfAliveBots = 0;
-	for (TActorIterator<ASAICharacter> It(GetWorld()); It; ++It) // see comments below for alternate implementations
+	// Accrue spawn points, waves spend them based on FMonsterInfoRow::SpawnCost
+	float PointsPerSecond = SpawnPointsPerSecond;
+	if (SpawnPointsCurve)
 	{
-		ASAICharacter* Bot = *It;
-
-		USAttributeComponent* AttributeComp = USAttributeComponent::GetAttributes(Bot);
-		if (ensure(AttributeComp) && AttributeComp->IsAlive())
-		{
-			NrOfAliveBots++;
-		}
+		PointsPerSecond = SpawnPointsCurve->GetFloatValue(GetWorld()->TimeSeconds);
 	}
-	// Instead of TActorIterator we could have also used UGameplayStatics::GetAllActorsOfClass -> then for loop the result
-	// or TActorRange
-	// for (ASAICharacter* Bot : TActorRange<ASAICharacter>(GetWorld())) {for loop body stays the same}
+	AvailableSpawnPoints = FMath::Min(AvailableSpawnPoints + PointsPerSecond * SpawnTimerInterval, MaxSpawnPoints);
+
+	// Bots register themselves in the registry on BeginPlay and leave it when they die,
+	// so the alive count is available without walking every ASAICharacter with TActorIterator (or UGameplayStatics::GetAllActorsOfClass / TActorRange).
+	USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+	int32 NrOfAliveBots = BotRegistry ? BotRegistry->GetNumAliveBots() : 0;
 
-	UE_LOG(LogTemp, Log, TEXT("Found %i alive bots."), NrOfAliveBots);
+	// Bots of the current wave that are not spawned yet still count towards capacity
+	int32 NrOfPendingBots = BotSpawnQueue.Num() + NrOfBotsLoading;
+
+	UE_LOG(LogTemp, Log, TEXT("Found %i alive bots (%i pending). Spawn points: %f"), NrOfAliveBots, NrOfPendingBots, AvailableSpawnPoints);
 
 	float MaxBotCount = 10.0f; // we used a float curve for DifficultyCurve asset hence this is a float and not an int
 
@@ -132,63 +448,135 @@ void ASGameModeBase::SpawnBotTimerElapsed()
 		MaxBotCount = DifficultyCurve->GetFloatValue(GetWorld()->TimeSeconds); // if we have assigned a DifficultyCurve set MaxBotCount to that value in time
 	}
 
-	if (NrOfAliveBots >= MaxBotCount) // don't spawn a new bot if too many exist
+	// Soak benchmark (see USSoakBenchmarkSubsystem) holds an exact bot count, refill as fast as spawn locations allow
+	int32 ForcedBotCount = CVarForceBotCount.GetValueOnGameThread();
+	bool bForceBotCount = ForcedBotCount > 0;
+	if (bForceBotCount)
+	{
+		MaxBotCount = ForcedBotCount;
+	}
+
+	if (NrOfAliveBots + NrOfPendingBots >= MaxBotCount) // don't spawn a new bot if too many exist
 	{
 		UE_LOG(LogTemp, Log, TEXT("At maximum bot capacity. Skipping bot spawn."));
 		return;
 	}
 
-	// quit early - only execute an EQSQuery if bot count < max! this should save some performance.
-	UEnvQueryInstanceBlueprintWrapper* QueryInstance = UEnvQueryManager::RunEQSQuery(this, SpawnBotQuery, this, EEnvQueryRunMode::RandomBest5Pct, nullptr);
-	if (ensure(QueryInstance))
+	// Spawn locations come from the cached SpawnBotQuery results, refreshed in the background as players move around
+	USSpawnLocationCache* SpawnLocationCache = GetWorld()->GetSubsystem<USSpawnLocationCache>();
+	SpawnLocationCache->UpdateCache();
+
+	// Very first query is still running (or found nothing)
+	if (SpawnLocationCache->GetNumAvailable() == 0)
+	{
+		return;
+	}
+
+	// Plan the wave : keep buying monsters until we run out of points, free slots or spawn locations.
+	// If the picked monster is too expensive we stop and save up for it, instead of re-rolling for a cheaper one (keeps Weight meaningful).
+	int32 FreeSlots = FMath::FloorToInt(MaxBotCount) - NrOfAliveBots - NrOfPendingBots;
+	if (!bForceBotCount)
 	{
-		QueryInstance->GetOnQueryFinishedEvent().AddDynamic(this, &ASGameModeBase::OnBotSpawnQueryCompleted);
+		FreeSlots = FMath::Min(FreeSlots, MaxWaveSize);
+	}
+	FreeSlots = FMath::Min(FreeSlots, SpawnLocationCache->GetNumAvailable());
+	float RemainingPoints = bForceBotCount ? BIG_NUMBER : AvailableSpawnPoints;
+
+	FRandomStream& MonsterStream = GetWorld()->GetSubsystem<USRandomSubsystem>()->GetStream(USRandomSubsystem::MonsterSpawnChannel);
+
+	TArray<FPrimaryAssetId> PlannedWave;
+	while (PlannedWave.Num() < FreeSlots)
+	{
+		const FMonsterInfoRow* SelectedRow = MonsterCatalog.PickRandomRow(MonsterStream);
+		if (SelectedRow == nullptr || SelectedRow->SpawnCost > RemainingPoints)
+		{
+			break;
+		}
+
+		RemainingPoints -= SelectedRow->SpawnCost;
+		PlannedWave.Add(SelectedRow->MonsterId);
+	}
+
+	if (PlannedWave.Num() == 0)
+	{
+		return;
+	}
+
+	if (!bForceBotCount)
+	{
+		AvailableSpawnPoints = RemainingPoints;
+	}
+
+	// Distinct locations so bots of the same wave don't stack. Always enough of them, FreeSlots was capped above.
+	TArray<FVector> Locations;
+	SpawnLocationCache->TakeLocations(PlannedWave.Num(), MonsterStream, Locations);
+
+	for (int32 i = 0; i < PlannedWave.Num(); i++)
+	{
+		FPendingBotSpawn PendingSpawn;
+		PendingSpawn.MonsterId = PlannedWave[i];
+		PendingSpawn.Location = Locations[i];
+		BotSpawnQueue.Add(PendingSpawn);
+	}
+
+	if (BotSpawnQueue.Num() > 0 && !GetWorldTimerManager().IsTimerPending(TimerHandle_ProcessBotSpawnQueue))
+	{
+		TimerHandle_ProcessBotSpawnQueue = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessBotSpawnQueue);
 	}
 }
 
-void ASGameModeBase::OnBotSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrapper* QueryInstance, EEnvQueryStatus::Type QueryStatus)
+void ASGameModeBase::ProcessBotSpawnQueue()
 {
-	if (QueryStatus != EEnvQueryStatus::Success)
+	SCOPE_CYCLE_COUNTER(STAT_ProcessBotSpawnQueue);
+
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	USMonsterAssetCache* MonsterCache = GetWorld()->GetSubsystem<USMonsterAssetCache>();
+	if (!ensure(Manager && MonsterCache))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Spawn bot EQS Query failed!"));
+		BotSpawnQueue.Reset();
 		return;
 	}
 
-	TArray<FVector> Locations = QueryInstance->GetResultsAsLocations(); // actual function returns FOccluderVertexArray which is a typedef for TArray<FVector>
-
-	if (Locations.Num() > 0) // alternative : Locations.IsValidIndex(0)
+	// Spread the wave across frames, MaxBotSpawnsPerFrame at a time
+	int32 NumToSpawn = FMath::Min(BotSpawnQueue.Num(), FMath::Max(MaxBotSpawnsPerFrame, 1));
+	for (int32 i = 0; i < NumToSpawn; i++)
 	{
-		if (MonsterTable)
+		FPendingBotSpawn PendingSpawn = BotSpawnQueue.Pop(false); // spawn order within a wave does not matter
+
+		// Track al the used spawn locations
+		DrawDebugSphere(GetWorld(), PendingSpawn.Location, 50.0f, 20, FColor::Blue, false, 60.0f);
+
+		// Warm cache (preloaded in InitGame) : spawn right away
+		USMonsterData* MonsterData = MonsterCache->FindLoadedMonster(PendingSpawn.MonsterId);
+		if (MonsterData)
 		{
-			TArray<FMonsterInfoRow*> Rows;
-			MonsterTable->GetAllRows("", Rows);
+			SpawnMonster(MonsterData, PendingSpawn.Location);
+			continue;
+		}
 
-			// Get Random Enemy
-			int32 RandomIndex = FMath::RandRange(0, Rows.Num() - 1);
-			FMonsterInfoRow* SelectedRow = Rows[RandomIndex];
+		// Cache miss (preload still running or table edited in PIE) : fall back to loading it now
+		LogOnScreen(this, "Loading monster...", FColor::Green);
 
-			UAssetManager* Manager = UAssetManager::GetIfValid();
-			if (Manager)
-			{
-				LogOnScreen(this, "Loading monster...", FColor::Green);
+		TArray<FName> Bundles; // empty on purpose
 
-				TArray<FName> Bundles; // empty on purpose
+		// similar syntax to deleagate with params for timers
+		FStreamableDelegate Delegate = FStreamableDelegate::CreateUObject(this, &ASGameModeBase::OnMonsterLoaded, PendingSpawn.MonsterId, PendingSpawn.Location);
 
-				// similar syntax to deleagate with params for timers
-				FStreamableDelegate Delegate = FStreamableDelegate::CreateUObject(this, &ASGameModeBase::OnMonsterLoaded, SelectedRow->MonsterId, Locations[0]);
-				
-				// finally start loading the asset (async) and execute the delegate when loading finishes
-				Manager->LoadPrimaryAsset(SelectedRow->MonsterId, Bundles, Delegate);
-			}
-		}
+		// finally start loading the asset (async) and execute the delegate when loading finishes
+		NrOfBotsLoading++;
+		Manager->LoadPrimaryAsset(PendingSpawn.MonsterId, Bundles, Delegate);
+	}
 
-		// Track al the used spawn locations
-		DrawDebugSphere(GetWorld(), Locations[0], 50.0f, 20, FColor::Blue, false, 60.0f);
+	if (BotSpawnQueue.Num() > 0)
+	{
+		TimerHandle_ProcessBotSpawnQueue = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessBotSpawnQueue);
 	}
 }
 
 void ASGameModeBase::OnMonsterLoaded(FPrimaryAssetId LoadedId, FVector SpawnLocation)
 {
+	NrOfBotsLoading = FMath::Max(NrOfBotsLoading - 1, 0);
+
 	LogOnScreen(this, "Finished loading.", FColor::Green);
 
 	UAssetManager* Manager = UAssetManager::GetIfValid();
@@ -197,20 +585,37 @@ void ASGameModeBase::OnMonsterLoaded(FPrimaryAssetId LoadedId, FVector SpawnLoca
 		USMonsterData* MonsterData = Cast<USMonsterData>(Manager->GetPrimaryAssetObject(LoadedId));
 		if (MonsterData)
 		{
-			AActor* NewBot = GetWorld()->SpawnActor<AActor>(MonsterData->MonsterClass, SpawnLocation, FRotator::ZeroRotator);
-			if (NewBot)
+			SpawnMonster(MonsterData, SpawnLocation);
+		}
+	}
+}
+
+void ASGameModeBase::SpawnMonster(USMonsterData* MonsterData, FVector SpawnLocation)
+{
+	// Reuse a dead bot of the same class when possible, only spawn (+ possess by a new AI controller) on a pool miss
+	AActor* NewBot = nullptr;
+	USBotPoolSubsystem* BotPool = GetWorld()->GetSubsystem<USBotPoolSubsystem>();
+	if (BotPool)
+	{
+		NewBot = BotPool->AcquireBot(MonsterData->MonsterClass, SpawnLocation, FRotator::ZeroRotator);
+	}
+
+	if (NewBot == nullptr)
+	{
+		NewBot = GetWorld()->SpawnActor<AActor>(MonsterData->MonsterClass, SpawnLocation, FRotator::ZeroRotator);
+	}
+
+	if (NewBot)
+	{
+		LogOnScreen(this, FString::Printf(TEXT("Spawned enemy: %s (%s)"), *GetNameSafe(NewBot), *GetNameSafe(MonsterData)));
+
+		// Grant special actions, buffs etc.
+		USActionComponent* ActionComp = Cast<USActionComponent>(NewBot->GetComponentByClass(USActionComponent::StaticClass()));
+		if (ActionComp)
+		{
+			for (TSubclassOf<USAction> ActionClass : MonsterData->Actions)
 			{
-				LogOnScreen(this, FString::Printf(TEXT("Spawned enemy: %s (%s)"), *GetNameSafe(NewBot), *GetNameSafe(MonsterData)));
-
-				// Grant special actions, buffs etc.
-				USActionComponent* ActionComp = Cast<USActionComponent>(NewBot->GetComponentByClass(USActionComponent::StaticClass()));
-				if (ActionComp)
-				{
-					for (TSubclassOf<USAction> ActionClass : MonsterData->Actions)
-					{
-						ActionComp->AddAction(NewBot, ActionClass);
-					}
-				}
+				ActionComp->AddAction(NewBot, ActionClass);
 			}
 		}
 	}
@@ -226,52 +631,41 @@ void ASGameModeBase::OnPowerupSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrap
 
 	TArray<FVector> Locations = QueryInstance->GetResultsAsLocations();
 
-	// Keep used locations to easily check distance between points
-	TArray<FVector> UsedLocations;
-
-	int32 SpawnCounter = 0;
-	// Break out if we reached the desired count or if we have no more potential positions remaining
-	while (SpawnCounter < DesiredPowerupCount && Locations.Num() > 0)
 	{
-		// Pick a random location from remaining points.
-		int32 RandomLocationIndex = FMath::RandRange(0, Locations.Num() - 1);
+		SCOPE_CYCLE_COUNTER(STAT_PlacePowerups);
 
-		FVector PickedLocation = Locations[RandomLocationIndex];
-		// Remove to avoid picking again
-		Locations.RemoveAt(RandomLocationIndex);
+		// Grid based rejection keeps this linear in the amount of EQS results, the old pairwise distance check went quadratic on large maps
+		FRandomStream& PowerupStream = GetWorld()->GetSubsystem<USRandomSubsystem>()->GetStream(USRandomSubsystem::PowerupsChannel);
+		FPlacementGrid::SelectLocations(Locations, RequiredPowerupDistance, DesiredPowerupCount, PowerupStream, PowerupSpawnQueue);
+	}
 
-		// Check minimum distance requirement
-		bool bValidLocation = true;
-		for (FVector OtherLocation : UsedLocations)
-		{
-			float DistanceTo = (PickedLocation - OtherLocation).Size();
+	if (PowerupSpawnQueue.Num() > 0 && !GetWorldTimerManager().IsTimerPending(TimerHandle_ProcessPowerupSpawnQueue))
+	{
+		TimerHandle_ProcessPowerupSpawnQueue = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessPowerupSpawnQueue);
+	}
+}
 
-			if (DistanceTo < RequiredPowerupDistance)
-			{
-				// Show skipped locations due to distance
-				//DrawDebugSphere(GetWorld(), PickedLocation, 50.0f, 20, FColor::Red, false, 10.0f);
+void ASGameModeBase::ProcessPowerupSpawnQueue()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProcessPowerupSpawnQueue);
 
-				// too close, skip to next attempt
-				bValidLocation = false;
-				break;
-			}
-		}
+	FRandomStream& PowerupStream = GetWorld()->GetSubsystem<USRandomSubsystem>()->GetStream(USRandomSubsystem::PowerupsChannel);
 
-		// Failed the distance test
-		if (!bValidLocation)
-		{
-			continue;
-		}
+	int32 NumToSpawn = FMath::Min(PowerupSpawnQueue.Num(), FMath::Max(MaxPowerupSpawnsPerFrame, 1));
+	for (int32 i = 0; i < NumToSpawn; i++)
+	{
+		FVector PickedLocation = PowerupSpawnQueue.Pop(false);
 
 		// Pick a random powerup-class
-		int32 RandomClassIndex = FMath::RandRange(0, PowerupClasses.Num() - 1);
+		int32 RandomClassIndex = PowerupStream.RandRange(0, PowerupClasses.Num() - 1);
 		TSubclassOf<AActor> RandomPowerupClass = PowerupClasses[RandomClassIndex];
 
 		GetWorld()->SpawnActor<AActor>(RandomPowerupClass, PickedLocation, FRotator::ZeroRotator);
+	}
 
-		// Keep for distance checks
-		UsedLocations.Add(PickedLocation);
-		SpawnCounter++;
+	if (PowerupSpawnQueue.Num() > 0)
+	{
+		TimerHandle_ProcessPowerupSpawnQueue = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessPowerupSpawnQueue);
 	}
 }
 
@@ -317,6 +711,13 @@ void ASGameModeBase::OnActorKilled(AActor* VictimActor, AActor* Killer)
 		// GetWorldTimerManager().SetTimer(TimerHandle_RespawnDelay, this, &ASGameModeBase::RespawnPlayerElapsed, RespawnDelay);
 	}
 
+	// Wave cleared : last alive bot died and nothing left to spawn
+	if (Cast<ASAICharacter>(VictimActor) && GetWorld()->GetSubsystem<USBotRegistrySubsystem>()->GetNumAliveBots() == 0
+		&& BotSpawnQueue.Num() == 0 && NrOfBotsLoading == 0)
+	{
+		RequestAutosave();
+	}
+
 	APawn* KillerPawn = Cast<APawn>(Killer);
 	// Don't credit kills of self
 	if (KillerPawn && KillerPawn != VictimActor)
@@ -332,121 +733,695 @@ void ASGameModeBase::OnActorKilled(AActor* VictimActor, AActor* Killer)
 
 void ASGameModeBase::WriteSaveGame()
 {
-	// Iterate all player states, we don't have proper ID to match yet (requires Steam or EOS)
-	for (int32 i = 0; i < GameState->PlayerArray.Num(); i++)
+	// Back-pressure : never more than one write in flight. Also wait for the load, FinishSaveGameLoad picks it up.
+	if (bSaveInFlight || bSaveGameLoading)
+	{
+		bSaveQueued = true;
+		return;
+	}
+
+	// Same steps as an autosave, all in this frame. Also completes an autosave that is still being spread across frames.
+	if (!bActorSaveInProgress)
+	{
+		BeginActorSave();
+	}
+
+	SerializeSaveQueue(0.0f);
+	FinishActorSave();
+}
+
+void ASGameModeBase::RequestAutosave()
+{
+	if (!CVarAutosave.GetValueOnGameThread() || bActorSaveInProgress || bSaveGameLoading || CurrentSaveGame == nullptr)
+	{
+		return;
+	}
+
+	BeginActorSave();
+
+	TimerHandle_ProcessAutosave = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessAutosave);
+}
+
+void ASGameModeBase::ProcessAutosave()
+{
+	// WriteSaveGame finished it for us
+	if (!bActorSaveInProgress)
+	{
+		return;
+	}
+
+	if (SerializeSaveQueue(AutosaveFrameBudgetMs))
 	{
-		ASPlayerState* PS = Cast<ASPlayerState>(GameState->PlayerArray[i]);
+		FinishActorSave();
+		return;
+	}
+
+	TimerHandle_ProcessAutosave = GetWorldTimerManager().SetTimerForNextTick(this, &ASGameModeBase::ProcessAutosave);
+}
+
+void ASGameModeBase::BeginActorSave()
+{
+	bActorSaveInProgress = true;
+	NumActorsSerialized = 0;
+	NumSaveFrames = 0;
+
+	SaveQueue.Reset();
+
+	if (bFullSaveRequired)
+	{
+		// clear saved actors array before saving 
+		// otherwise we end up appending actors to (previously saved/loaded) CurrentSaveGame
+		// Not only will the SaveGame grow big in size as more saves happen
+		// but loading would also be broken as the game would always load "the first version" ever saved of the previously saved actors
+		CurrentSaveGame->SavedActors.Empty(); 
+		CurrentSaveGame->BuildActorIndex();
+
+		// Only actors that opted in to saving. Queue is worked on from the back, add them lowest priority first.
+		USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+		const TArray<AActor*>& Actors = SaveRegistry->GetActors();
+		for (int32 i = Actors.Num() - 1; i >= 0; i--)
+		{
+			SaveQueue.Add(Actors[i]);
+		}
+
+		bFullSaveRequired = false;
+	}
+	else
+	{
+		// Everything else is unchanged since the last save, patch only the dirty actors into it
+		for (const TWeakObjectPtr<AActor>& DirtyActor : DirtySaveActors)
+		{
+			SaveQueue.Add(DirtyActor);
+		}
+	}
+
+	// From here on DirtySaveActors collects changes made while the queue is being worked on, see FinishActorSave
+	DirtySaveActors.Reset();
+}
+
+bool ASGameModeBase::SerializeSaveQueue(float BudgetMs)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameSnapshot);
+	double StartTime = FPlatformTime::Seconds();
+
+	NumSaveFrames++;
+
+	// Always makes progress, at least one actor per call even if it alone blows the budget
+	while (SaveQueue.Num() > 0)
+	{
+		AActor* Actor = SaveQueue.Pop(false).Get();
+		if (Actor && !Actor->IsPendingKill())
+		{
+			SerializeActorForSave(Actor, CurrentSaveGame->FindOrAddActorData(Actor->GetFName()));
+			NumActorsSerialized++;
+		}
+
+		if (BudgetMs > 0.0f && (FPlatformTime::Seconds() - StartTime) * 1000.0 >= BudgetMs)
+		{
+			break;
+		}
+	}
+
+	SET_FLOAT_STAT(STAT_AutosaveSliceMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return SaveQueue.Num() == 0;
+}
+
+void ASGameModeBase::FinishActorSave()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameSnapshot);
+	double SnapshotStartTime = FPlatformTime::Seconds();
+
+	// Actors changed on an earlier frame after they were serialized would leave the save with a mix of old and new state.
+	// Serialize those again in this frame, the save then matches the world as it is right now (also for the player state below).
+	for (const TWeakObjectPtr<AActor>& DirtyActor : DirtySaveActors)
+	{
+		AActor* Actor = DirtyActor.Get();
+		if (Actor && !Actor->IsPendingKill())
+		{
+			SerializeActorForSave(Actor, CurrentSaveGame->FindOrAddActorData(Actor->GetFName()));
+			NumActorsSerialized++;
+		}
+	}
+
+	DirtySaveActors.Reset();
+
+	SavePlayerRecords();
+
+	bActorSaveInProgress = false;
+	GetWorldTimerManager().ClearTimer(TimerHandle_ProcessAutosave);
+
+	SET_DWORD_STAT(STAT_SaveGameActorsSerialized, NumActorsSerialized);
+	SET_DWORD_STAT(STAT_AutosaveFrames, NumSaveFrames);
+	SET_FLOAT_STAT(STAT_SaveGameSnapshotMs, (FPlatformTime::Seconds() - SnapshotStartTime) * 1000.0);
+
+	StartSaveWrite();
+}
+
+void ASGameModeBase::SavePlayerRecords()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SavePlayerRecords);
+
+	// One record per player, keyed by unique net id. All on the game thread : SavePlayerState may run Blueprint
+	// and Serialize() walks UObject state that gameplay code is free to touch. The byte heavy part (packing and
+	// compressing the records) already happens on the save worker, see StartSaveWrite().
+	for (APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		ASPlayerState* PS = Cast<ASPlayerState>(PlayerState);
 		if (PS)
 		{
 			PS->SavePlayerState(CurrentSaveGame);
-			break; // single player only at this point
+			PS->SerializeSaveData(CurrentSaveGame->FindOrAddPlayerData(PS->GetSaveId()));
 		}
 	}
+}
+
+void ASGameModeBase::Logout(AController* Exiting)
+{
+	// Keep the record of a player leaving mid match up to date, the next save no longer sees them in PlayerArray
+	ASPlayerState* PS = Exiting ? Exiting->GetPlayerState<ASPlayerState>() : nullptr;
+	if (PS && bSavePlayersLoading)
+	{
+		// Never got its record, the one in the file is still the latest
+		PlayersAwaitingSaveGame.Remove(PS);
+	}
+	else if (PS && CurrentSaveGame)
+	{
+		PS->SavePlayerState(CurrentSaveGame);
+		PS->SerializeSaveData(CurrentSaveGame->FindOrAddPlayerData(PS->GetSaveId()));
+	}
 
-	// clear saved actors array before saving 
-	// otherwise we end up appending actors to (previously saved/loaded) CurrentSaveGame
-	// Not only will the SaveGame grow big in size as more saves happen
-	// but loading would also be broken as the game would always load "the first version" ever saved of the previously saved actors
-	CurrentSaveGame->SavedActors.Empty(); 
+	Super::Logout(Exiting);
+}
 
-	for (FActorIterator It(GetWorld()); It; ++It) // see comments above in SpawnBotTimerElapsed() for alternate implementations
+void ASGameModeBase::StartSaveWrite()
+{
+	// An autosave finished while the previous write is still running, the follow-up WriteSaveGame picks up CurrentSaveGame as it is by then
+	if (bSaveInFlight)
 	{
-		AActor* Actor = *It;
-		// Only interested in our 'gameplay actors'
-		if (!Actor->Implements<USGameplayInterface>()) // we could search using a filter above e.g. make a new interface like USSaveGameInterface
+		bSaveQueued = true;
+		return;
+	}
+
+	// Everything below the actors' own Serialize() (packing the save, compression and disk IO) happens on a worker thread.
+	// It gets its own copy, we are free to keep changing CurrentSaveGame meanwhile.
+	TSharedRef<FSaveGameSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FSaveGameSnapshot, ESPMode::ThreadSafe>();
+	FSaveGameFile::MakeSnapshot(CurrentSaveGame, *Snapshot);
+
+	bSaveInFlight = true;
+
+	TWeakObjectPtr<ASGameModeBase> WeakThis(this);
+	FString SaveSlotName = SlotName;
+
+	PendingSaveWrite = Async(EAsyncExecution::ThreadPool, [WeakThis, Snapshot, SaveSlotName]()
+	{
+		FSaveGameWriteResult Result;
+		FSaveGameFile::Write(*Snapshot, SaveSlotName, 0, Result);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Result]()
 		{
-			continue;
-		}
+			if (WeakThis.IsValid() && !WeakThis->bHasEndedPlay)
+			{
+				WeakThis->OnSaveGameWriteFinished(Result);
+			}
+		});
+	});
+}
+
+void ASGameModeBase::SerializeActorForSave(AActor* Actor, FActorSaveData& ActorData)
+{
+	ActorData.ActorName = Actor->GetFName();
+	ActorData.Transform = Actor->GetActorTransform();
+	ActorData.ByteData.Reset(); // might be patching a previous save of this actor
+
+	///// NOTE : comments about saving taken from : https://www.tomlooman.com/unreal-engine-cpp-save-system/
+	// also see comments in LoadSaveGame()
+	 
+	// To convert variables into a binary array we need an FMemoryWriter. 
+	// Pass the array to fill with data from Actor
+	FMemoryWriter MemWriter(ActorData.ByteData);
+
+	// FObjectAndNameAsStringProxyArchive which is derived from FArchive
+	// (Unreals data container for all sorts of serialized data including your game content).
+	FObjectAndNameAsStringProxyArchive Ar(MemWriter, true);
+
+	// Find only variables with UPROPERTY(SaveGame)
+	Ar.ArIsSaveGame = true;
+
+	// Converts Actor's SaveGame UPROPERTIES into binary array
+	// the Serialize() function available in every UObject / Actor 
+	// to convert our variables to a binary array and back into variables again. 
+	// To decide which variables to store, Unreal uses a SaveGame UPROPERTY specifier.
+	Actor->Serialize(Ar);
+}
+
+void ASGameModeBase::OnSaveGameWriteFinished(const FSaveGameWriteResult& Result)
+{
+	bSaveInFlight = false;
+
+	SET_FLOAT_STAT(STAT_SaveGameSerializeMs, Result.SerializeMs);
+	SET_FLOAT_STAT(STAT_SaveGameCompressMs, Result.CompressMs);
+	SET_FLOAT_STAT(STAT_SaveGameWriteMs, Result.WriteMs);
+	SET_DWORD_STAT(STAT_SaveGameBytes, Result.CompressedBytes);
+
+	if (Result.bSuccess)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SaveGame: Wrote slot '%s', %i bytes (%i uncompressed). Serialize: %.2f ms, compress: %.2f ms, write: %.2f ms."),
+			*SlotName, Result.CompressedBytes, Result.UncompressedBytes, Result.SerializeMs, Result.CompressMs, Result.WriteMs);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Failed to write slot '%s'."), *SlotName);
+	}
 
-		FActorSaveData ActorData;
-		ActorData.ActorName = Actor->GetName();
-		ActorData.Transform = Actor->GetActorTransform();
+	OnSaveGameWritten.Broadcast(SlotName, Result.bSuccess);
 
-		///// NOTE : comments about saving taken from : https://www.tomlooman.com/unreal-engine-cpp-save-system/
-		// also see comments in LoadSaveGame()
-		 
-		// To convert variables into a binary array we need an FMemoryWriter. 
-		// Pass the array to fill with data from Actor
-		FMemoryWriter MemWriter(ActorData.ByteData);
+	// Requested while we were busy, save the latest state now
+	if (bSaveQueued)
+	{
+		bSaveQueued = false;
+		WriteSaveGame();
+	}
+}
 
-		// FObjectAndNameAsStringProxyArchive which is derived from FArchive
-		// (Unreals data container for all sorts of serialized data including your game content).
-		FObjectAndNameAsStringProxyArchive Ar(MemWriter, true);
+bool ASGameModeBase::IsSaveGameInFlight() const
+{
+	return bSaveInFlight;
+}
 
-		// Find only variables with UPROPERTY(SaveGame)
-		Ar.ArIsSaveGame = true;
+void ASGameModeBase::MarkActorSaveDirty(AActor* Actor)
+{
+	if (Actor)
+	{
+		DirtySaveActors.Add(Actor);
+	}
+}
 
-		// Converts Actor's SaveGame UPROPERTIES into binary array
-		// the Serialize() function available in every UObject / Actor 
-		// to convert our variables to a binary array and back into variables again. 
-		// To decide which variables to store, Unreal uses a SaveGame UPROPERTY specifier.
-		Actor->Serialize(Ar);
+void ASGameModeBase::OnSaveActorRegistered(AActor* Actor)
+{
+	MarkActorSaveDirty(Actor);
+}
 
-		CurrentSaveGame->SavedActors.Add(ActorData);
+void ASGameModeBase::OnSaveActorUnregistered(AActor* Actor)
+{
+	// Streamed out or the map is going away : the actor comes back later, keep its entry
+	if (!Actor->IsActorBeingDestroyed() || bHasEndedPlay || GetWorld()->bIsTearingDown)
+	{
+		return;
 	}
 
-	UGameplayStatics::SaveGameToSlot(CurrentSaveGame, SlotName, 0);
+	DirtySaveActors.Remove(Actor);
+
+	if (CurrentSaveGame)
+	{
+		CurrentSaveGame->RemoveActorData(Actor->GetFName());
+	}
 }
 
+/* Shared between the load worker and the game thread. The worker fills Players, then Actors, each is only handed to the game thread once complete. */
+struct FSaveGameLoadState
+{
+	TArray<uint8> FileData;
+
+	bool bExists = false;
+
+	/* Written by UGameplayStatics::SaveGameToSlot, only the game thread can read those */
+	bool bEngineFormat = false;
+
+	bool bPlayersRead = false;
+
+	bool bActorsRead = false;
+
+	double ReadMs = 0.0;
+
+	FSaveGameSnapshot Players;
+
+	FSaveGameSnapshot Actors;
+};
+
 void ASGameModeBase::LoadSaveGame()
 {
-	if (UGameplayStatics::DoesSaveGameExist(SlotName, 0))
+	// Filled in by OnSavePlayersLoaded/OnSaveActorsLoaded, stays empty when there is no save yet
+	CurrentSaveGame = Cast<USSaveGame>(UGameplayStatics::CreateSaveGameObject(USSaveGame::StaticClass()));
+
+	bSaveGameLoading = true;
+	bSavePlayersLoading = true;
+
+	TSharedRef<FSaveGameLoadState, ESPMode::ThreadSafe> LoadState = MakeShared<FSaveGameLoadState, ESPMode::ThreadSafe>();
+
+	TWeakObjectPtr<ASGameModeBase> WeakThis(this);
+	FString LoadSlotName = SlotName;
+
+	// Disk IO and decompression off the game thread, the map keeps initializing meanwhile
+	PendingSaveLoad = Async(EAsyncExecution::ThreadPool, [WeakThis, LoadState, LoadSlotName]()
 	{
-		CurrentSaveGame = Cast<USSaveGame>(UGameplayStatics::LoadGameFromSlot(SlotName, 0));
-		if (CurrentSaveGame == nullptr)
+		double StartTime = FPlatformTime::Seconds();
+
+		LoadState->bExists = FSaveGameFile::ReadSlot(LoadSlotName, 0, LoadState->FileData);
+		if (LoadState->bExists)
+		{
+			LoadState->bPlayersRead = FSaveGameFile::ReadSnapshot(LoadState->FileData, ESaveGameSections::Player, LoadState->Players, LoadSlotName, LoadState->bEngineFormat);
+		}
+
+		// Player records are small, hand them over first so joining players don't wait on the actors
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, LoadState]()
+		{
+			if (WeakThis.IsValid() && !WeakThis->bHasEndedPlay)
+			{
+				WeakThis->OnSavePlayersLoaded(*LoadState);
+			}
+		});
+
+		if (!LoadState->bPlayersRead)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Failed to load SaveGame Data."));
 			return;
 		}
 
-		UE_LOG(LogTemp, Warning, TEXT("Loaded SaveGame Data."));
+		bool bEngineFormat = false;
+		LoadState->bActorsRead = FSaveGameFile::ReadSnapshot(LoadState->FileData, ESaveGameSections::Actors, LoadState->Actors, LoadSlotName, bEngineFormat);
+		LoadState->ReadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
 
-		for (FActorIterator It(GetWorld()); It; ++It) // see comments above in SpawnBotTimerElapsed() for alternate implementations
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, LoadState]()
 		{
-			AActor* Actor = *It;
-			// Only interested in our 'gameplay actors'
-			if (!Actor->Implements<USGameplayInterface>())
+			if (WeakThis.IsValid() && !WeakThis->bHasEndedPlay)
 			{
-				continue;
+				WeakThis->OnSaveActorsLoaded(*LoadState);
 			}
+		});
+	});
+}
 
-			for (FActorSaveData ActorData : CurrentSaveGame->SavedActors)
-			{
-				if (ActorData.ActorName == Actor->GetName()) 
-				{
-					Actor->SetActorTransform(ActorData.Transform);	
+void ASGameModeBase::OnSavePlayersLoaded(FSaveGameLoadState& LoadState)
+{
+	bool bActorsPending = false;
 
-					///// NOTE : comments about saving taken from : https://www.tomlooman.com/unreal-engine-cpp-save-system/
-					// also see comments in WriteSaveGame()
+	if (!LoadState.bExists)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Created New SaveGame Data."));
+	}
+	else if (LoadState.bPlayersRead)
+	{
+		FSaveGameFile::ApplySnapshot(LoadState.Players, CurrentSaveGame, ESaveGameSections::Player);
 
-					// use an FMemoryReader to convert each Actors binary data back into Unreal Variables.
-					FMemoryReader MemReader(ActorData.ByteData);
+		// Worker is still busy with the actor section
+		bActorsPending = true;
+	}
+	else if (LoadState.bEngineFormat)
+	{
+		// Slot written by UGameplayStatics::SaveGameToSlot, the worker is done with FileData by now
+		USSaveGame* LoadedSaveGame = FSaveGameFile::LoadFromMemory(LoadState.FileData, ESaveGameSections::All, SlotName);
+		if (LoadedSaveGame)
+		{
+			CurrentSaveGame = LoadedSaveGame;
+			CurrentSaveGame->BuildActorIndex();
+			bRestoreSavedActors = true;
 
-					FObjectAndNameAsStringProxyArchive Ar(MemReader, true);
-					Ar.ArIsSaveGame = true;
+			UE_LOG(LogTemp, Warning, TEXT("Loaded SaveGame Data."));
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to load SaveGame Data."));
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to load SaveGame Data."));
+	}
 
-					// Convert binary array back into actor's variables
-					// Somewhat confusingly we still use Serialize() on the Actor, 
-					// but because we pass in an FMemoryReader instead of an FMemoryWriter 
-					// the function can be used to pass saved variables back into the Actors.
-					Actor->Serialize(Ar);
+	bSavePlayersLoading = false;
 
-					ISGameplayInterface::Execute_OnActorLoaded(Actor);
+	for (TWeakObjectPtr<ASPlayerState>& PS : PlayersAwaitingSaveGame)
+	{
+		if (PS.IsValid())
+		{
+			PS->LoadPlayerState(CurrentSaveGame);
+		}
+	}
+	PlayersAwaitingSaveGame.Empty();
 
-					break; // we found the actor to restore its saved data - time to search for next actor in world to load its saved data.
-				}
-			}
+	if (!bActorsPending)
+	{
+		FinishSaveGameLoad();
+	}
+}
 
+void ASGameModeBase::OnSaveActorsLoaded(FSaveGameLoadState& LoadState)
+{
+	SET_FLOAT_STAT(STAT_SaveGameLoadMs, LoadState.ReadMs);
+
+	if (LoadState.bActorsRead)
+	{
+		FSaveGameFile::ApplySnapshot(LoadState.Actors, CurrentSaveGame, ESaveGameSections::Actors);
+
+		// Built once, restoring is a hash lookup per actor (was a scan of all SavedActors per actor)
+		CurrentSaveGame->BuildActorIndex();
+
+		// Actors join the save registry in BeginPlay, they are restored in StartPlay (RestoreSavedActors) or right away if that already happened
+		bRestoreSavedActors = true;
+
+		UE_LOG(LogTemp, Warning, TEXT("Loaded SaveGame Data."));
+		UE_LOG(LogTemp, Log, TEXT("SaveGame: Read slot '%s' (%i bytes, %i actors) in %.2f ms on a worker thread."), *SlotName, LoadState.FileData.Num(), CurrentSaveGame->SavedActors.Num(), LoadState.ReadMs);
+	}
+	else
+	{
+		// Players did load, keep them
+		UE_LOG(LogTemp, Warning, TEXT("Failed to load SaveGame Data."));
+	}
+
+	FinishSaveGameLoad();
+}
+
+void ASGameModeBase::FinishSaveGameLoad()
+{
+	bSaveGameLoading = false;
+
+	// Read took longer than the map, StartPlay found nothing to restore
+	if (GetWorld()->HasBegunPlay())
+	{
+		RestoreSavedActors();
+	}
+
+	// Saves requested while loading
+	if (bSaveQueued && !bSaveInFlight)
+	{
+		bSaveQueued = false;
+		WriteSaveGame();
+	}
+}
+
+void ASGameModeBase::RestoreSavedActors()
+{
+	if (!bRestoreSavedActors)
+	{
+		return;
+	}
+
+	bRestoreSavedActors = false;
+
+	SCOPE_CYCLE_COUNTER(STAT_SaveGameRestore);
+	double RestoreStartTime = FPlatformTime::Seconds();
+
+	int32 NumRestored = RestoreActors(CurrentSaveGame);
+
+	double RestoreMs = (FPlatformTime::Seconds() - RestoreStartTime) * 1000.0;
+
+	SET_DWORD_STAT(STAT_SaveGameActorsRestored, NumRestored);
+	SET_FLOAT_STAT(STAT_SaveGameActorsRestoredPerMs, RestoreMs > 0.0 ? NumRestored / RestoreMs : 0.0);
+
+	UE_LOG(LogTemp, Log, TEXT("SaveGame: Restored %i actors in %.2f ms."), NumRestored, RestoreMs);
+}
+
+int32 ASGameModeBase::RestoreActors(USSaveGame* SaveGame)
+{
+	int32 NumRestored = 0;
+
+	// Only actors that opted in to saving, highest priority first
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	for (AActor* Actor : SaveRegistry->GetActors())
+	{
+		if (RestoreActor(SaveGame, Actor))
+		{
+			NumRestored++;
+		}
+	}
+
+	return NumRestored;
+}
+
+bool ASGameModeBase::RestoreActor(USSaveGame* SaveGame, AActor* Actor)
+{
+	// Reference straight into the loaded save, copying it would also copy its ByteData
+	const FActorSaveData* ActorData = SaveGame->FindActorData(Actor->GetFName());
+	if (ActorData == nullptr)
+	{
+		return false;
+	}
+
+	Actor->SetActorTransform(ActorData->Transform);
+
+	///// NOTE : comments about saving taken from : https://www.tomlooman.com/unreal-engine-cpp-save-system/
+	// also see comments in WriteSaveGame()
+
+	// use an FMemoryReader to convert each Actors binary data back into Unreal Variables.
+	FMemoryReader MemReader(ActorData->ByteData);
+
+	FObjectAndNameAsStringProxyArchive Ar(MemReader, true);
+	Ar.ArIsSaveGame = true;
+
+	// Convert binary array back into actor's variables
+	// Somewhat confusingly we still use Serialize() on the Actor, 
+	// but because we pass in an FMemoryReader instead of an FMemoryWriter 
+	// the function can be used to pass saved variables back into the Actors.
+	Actor->Serialize(Ar);
+
+	if (Actor->Implements<USGameplayInterface>())
+	{
+		ISGameplayInterface::Execute_OnActorLoaded(Actor);
+	}
+
+	return true;
+}
+
+void ASGameModeBase::RunSaveBenchmarks(const TArray<int32>& NumActorsPerRun)
+{
+	if (bActorSaveInProgress)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveBenchmark: An autosave is running, try again later."));
+		return;
+	}
+
+	// Don't measure the disk while our own write is still busy with it
+	if (PendingSaveWrite.IsValid())
+	{
+		PendingSaveWrite.Wait();
+	}
+
+	FString Csv = FString(FSaveBenchmarkResult::CsvHeader) + TEXT("\n");
+
+	for (int32 NumActors : NumActorsPerRun)
+	{
+		if (NumActors > 0)
+		{
+			FSaveBenchmarkResult Result;
+			RunSaveBenchmark(GetWorld(), NumActors, Result);
+			Csv += Result.ToCsvRow() + TEXT("\n");
 		}
+	}
+
+	FString FileName = FPaths::ProfilingDir() / TEXT("SaveBenchmark") / FString::Printf(TEXT("SaveBenchmark_%s.csv"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Csv, *FileName);
+
+	UE_LOG(LogTemp, Log, TEXT("SaveBenchmark: Wrote results to '%s'."), *FileName);
+}
+
+void ASGameModeBase::RunSaveBenchmark(UWorld* World, int32 NumActors, FSaveBenchmarkResult& OutResult)
+{
+	OutResult = FSaveBenchmarkResult();
+	OutResult.NumActors = NumActors;
+
+	const FString BenchmarkSlotName = TEXT("SaveBenchmark");
+
+	// Spawning is not part of the measurement. Fixed seed and grid so runs are comparable between builds.
+	FRandomStream Stream(NumActors);
+	int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)NumActors));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<ASSaveBenchmarkActor*> BenchmarkActors;
+	BenchmarkActors.Reserve(NumActors);
+	for (int32 i = 0; i < NumActors; i++)
+	{
+		FVector Location((i % GridSize) * 100.0f, (i / GridSize) * 100.0f, -100000.0f); // out of sight below the level
+		ASSaveBenchmarkActor* Actor = World->SpawnActor<ASSaveBenchmarkActor>(Location, FRotator::ZeroRotator, SpawnParams);
+		if (Actor)
+		{
+			Actor->Randomize(Stream);
+			BenchmarkActors.Add(Actor);
+		}
+	}
 
+	uint64 BaselineMemory = FPlatformMemory::GetStats().UsedPhysical;
+	uint64 PeakMemory = BaselineMemory;
+	auto SampleMemory = [&PeakMemory]() { PeakMemory = FMath::Max<uint64>(PeakMemory, FPlatformMemory::GetStats().UsedPhysical); };
+
+	// Game thread part of a full save (every registered actor, not only the benchmark ones)
+	USSaveGame* BenchmarkSave = Cast<USSaveGame>(UGameplayStatics::CreateSaveGameObject(USSaveGame::StaticClass()));
+
+	double StartTime = FPlatformTime::Seconds();
+	USSaveGameRegistrySubsystem* SaveRegistry = World->GetSubsystem<USSaveGameRegistrySubsystem>();
+	for (AActor* Actor : SaveRegistry->GetActors())
+	{
+		SerializeActorForSave(Actor, BenchmarkSave->FindOrAddActorData(Actor->GetFName()));
+	}
+	OutResult.SerializeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	SampleMemory();
+
+	StartTime = FPlatformTime::Seconds();
+	FSaveGameSnapshot Snapshot;
+	FSaveGameFile::MakeSnapshot(BenchmarkSave, Snapshot);
+	OutResult.SnapshotMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	SampleMemory();
+
+	// Normally on a worker thread, run inline to time it
+	FSaveGameWriteResult WriteResult;
+	FSaveGameFile::Write(Snapshot, BenchmarkSlotName, 0, WriteResult);
+	SampleMemory();
+
+	StartTime = FPlatformTime::Seconds();
+	USSaveGame* LoadedSave = FSaveGameFile::Load(BenchmarkSlotName, 0);
+	OutResult.LoadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	SampleMemory();
+
+	OutResult.bLoaded = LoadedSave != nullptr;
+	if (LoadedSave)
+	{
+		StartTime = FPlatformTime::Seconds();
+		LoadedSave->BuildActorIndex();
+		OutResult.IndexMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// Includes OnActorLoaded. Only our own actors, the save also holds the real gameplay actors
+		// and loading those back would mess with the running game.
+		StartTime = FPlatformTime::Seconds();
+		for (ASSaveBenchmarkActor* Actor : BenchmarkActors)
+		{
+			if (RestoreActor(LoadedSave, Actor))
+			{
+				OutResult.NumRestored++;
+			}
+		}
+		OutResult.RestoreMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		SampleMemory();
 	}
 	else
 	{
-		CurrentSaveGame = Cast<USSaveGame>(UGameplayStatics::CreateSaveGameObject(USSaveGame::StaticClass()));
+		UE_LOG(LogTemp, Warning, TEXT("SaveBenchmark: Failed to load back slot '%s'."), *BenchmarkSlotName);
+	}
 
-		UE_LOG(LogTemp, Warning, TEXT("Created New SaveGame Data."));
+	for (ASSaveBenchmarkActor* Actor : BenchmarkActors)
+	{
+		Actor->Destroy();
 	}
+	UGameplayStatics::DeleteGameInSlot(BenchmarkSlotName, 0);
+
+	OutResult.NumSaved = BenchmarkSave->SavedActors.Num();
+	OutResult.PackMs = WriteResult.SerializeMs;
+	OutResult.CompressMs = WriteResult.CompressMs;
+	OutResult.WriteMs = WriteResult.WriteMs;
+	OutResult.BytesWritten = WriteResult.CompressedBytes;
+	OutResult.UncompressedBytes = WriteResult.UncompressedBytes;
+	OutResult.PeakMemoryDeltaMB = (PeakMemory - BaselineMemory) / (1024.0 * 1024.0);
+
+	UE_LOG(LogTemp, Log, TEXT("SaveBenchmark: %i actors (%i saved, %i restored) : serialize %.2f ms, snapshot %.2f ms, pack %.2f ms, compress %.2f ms, write %.2f ms, load %.2f ms, index %.2f ms, restore %.2f ms."),
+		NumActors, OutResult.NumSaved, OutResult.NumRestored, OutResult.SerializeMs, OutResult.SnapshotMs, OutResult.PackMs, OutResult.CompressMs, OutResult.WriteMs, OutResult.LoadMs, OutResult.IndexMs, OutResult.RestoreMs);
+	UE_LOG(LogTemp, Log, TEXT("SaveBenchmark: %i actors : %i bytes written (%i uncompressed), peak memory +%.1f MB."),
+		NumActors, OutResult.BytesWritten, OutResult.UncompressedBytes, OutResult.PeakMemoryDeltaMB);
+}
 
-	
+const TCHAR* FSaveBenchmarkResult::CsvHeader = TEXT("Actors,SerializeMs,SnapshotMs,PackMs,CompressMs,WriteMs,LoadMs,IndexMs,RestoreMs,BytesWritten,UncompressedBytes,PeakMemoryDeltaMB");
 
-}
\ No newline at end of file
+FString FSaveBenchmarkResult::ToCsvRow() const
+{
+	return FString::Printf(TEXT("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%i,%i,%.1f"),
+		NumActors, SerializeMs, SnapshotMs, PackMs, CompressMs, WriteMs, LoadMs, IndexMs, RestoreMs, BytesWritten, UncompressedBytes, PeakMemoryDeltaMB);
+}
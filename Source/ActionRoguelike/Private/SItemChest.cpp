@@ -4,6 +4,8 @@
 #include "SItemChest.h"
 #include "Components/StaticMeshComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "SGameModeBase.h"
+#include "SSaveGameRegistrySubsystem.h"
 
 void ASItemChest::Interact_Implementation(APawn* InstigatorPawn)
 {
@@ -14,6 +16,18 @@ void ASItemChest::Interact_Implementation(APawn* InstigatorPawn)
 	// because the server is responsible for setting the replicated values and does not receive them as replication
 	// the server has to call the RepNotifies manually. Explanation from : https://forums.unrealengine.com/t/repnotify-function-only-executes-on-clients-not-on-the-server/88010/
 	// Does the same apply to Blueprints as well though?
+
+	// bLidOpened is 'SaveGame' state, include us in the next save
+	ASGameModeBase* GM = GetWorld()->GetAuthGameMode<ASGameModeBase>();
+	if (GM)
+	{
+		GM->MarkActorSaveDirty(this);
+
+		if (bLidOpened)
+		{
+			GM->RequestAutosave();
+		}
+	}
 }
 
 void ASItemChest::OnActorLoaded_Implementation()
@@ -21,6 +35,11 @@ void ASItemChest::OnActorLoaded_Implementation()
 	OnRep_LidOpened(); // restore lid position after loading from a previously saved game
 }
 
+int32 ASItemChest::GetSavePriority_Implementation() const
+{
+	return 10;
+}
+
 void ASItemChest::OnRep_LidOpened() // automatically called on all clients when variable changes
 {
 	float currPitch = bLidOpened ? TargetPitch : 0.0f;
@@ -48,7 +67,23 @@ ASItemChest::ASItemChest()
 void ASItemChest::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->RegisterActor(this);
+	}
+}
+
+void ASItemChest::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
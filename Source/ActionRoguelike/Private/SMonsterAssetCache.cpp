@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SMonsterAssetCache.h"
+#include "SMonsterData.h"
+#include "Engine/AssetManager.h"
+#include "../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Monster Cache Hits"), STAT_MonsterCacheHits, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Monster Cache Misses"), STAT_MonsterCacheMisses, STATGROUP_STANFORD);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Monster Preload Time (ms)"), STAT_MonsterPreloadTime, STATGROUP_STANFORD);
+DECLARE_MEMORY_STAT(TEXT("Monster Assets Resident"), STAT_MonsterAssetsResident, STATGROUP_STANFORD);
+
+void USMonsterAssetCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumCacheHits = 0;
+	NumCacheMisses = 0;
+	TotalLoadTimeMs = 0.0;
+	ResidentBytes = 0;
+}
+
+void USMonsterAssetCache::Deinitialize()
+{
+	for (auto& Entry : PreloadHandles)
+	{
+		if (Entry.Value.IsValid())
+		{
+			Entry.Value->ReleaseHandle();
+		}
+	}
+	PreloadHandles.Empty();
+	LoadedMonsters.Empty();
+	OnMonsterReady.Clear();
+
+	SET_MEMORY_STAT(STAT_MonsterAssetsResident, 0);
+
+	Super::Deinitialize();
+}
+
+void USMonsterAssetCache::PreloadMonsters(const TArray<FPrimaryAssetId>& MonsterIds, const TArray<FName>& Bundles)
+{
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	if (!ensure(Manager))
+	{
+		return;
+	}
+
+	for (const FPrimaryAssetId& MonsterId : MonsterIds)
+	{
+		if (!MonsterId.IsValid() || PreloadHandles.Contains(MonsterId))
+		{
+			continue;
+		}
+
+		// Store the handle before the delegate may fire (it can complete immediately if the asset was already in memory)
+		TSharedPtr<FStreamableHandle>& Handle = PreloadHandles.Add(MonsterId);
+
+		FStreamableDelegate Delegate = FStreamableDelegate::CreateUObject(this, &USMonsterAssetCache::OnMonsterPreloaded, MonsterId, FPlatformTime::Seconds());
+		Handle = Manager->LoadPrimaryAsset(MonsterId, Bundles, Delegate);
+	}
+}
+
+void USMonsterAssetCache::OnMonsterPreloaded(FPrimaryAssetId MonsterId, double RequestTime)
+{
+	UAssetManager* Manager = UAssetManager::GetIfValid();
+	if (Manager == nullptr || LoadedMonsters.Contains(MonsterId))
+	{
+		return;
+	}
+
+	USMonsterData* MonsterData = Cast<USMonsterData>(Manager->GetPrimaryAssetObject(MonsterId));
+	if (MonsterData == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MonsterAssetCache: Failed to preload '%s'."), *MonsterId.ToString());
+		return;
+	}
+
+	LoadedMonsters.Add(MonsterId, MonsterData);
+
+	float LoadTimeMs = (FPlatformTime::Seconds() - RequestTime) * 1000.0;
+	TotalLoadTimeMs += LoadTimeMs;
+	INC_FLOAT_STAT_BY(STAT_MonsterPreloadTime, LoadTimeMs);
+
+	// Approximation : the data asset, the monster class (CDO) and anything loaded through the handle (bundles)
+	int64 AssetBytes = MonsterData->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	if (MonsterData->MonsterClass)
+	{
+		AssetBytes += MonsterData->MonsterClass->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		AssetBytes += MonsterData->MonsterClass->GetDefaultObject()->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+
+	TSharedPtr<FStreamableHandle>* Handle = PreloadHandles.Find(MonsterId);
+	if (Handle && Handle->IsValid())
+	{
+		TArray<UObject*> BundleAssets;
+		(*Handle)->GetLoadedAssets(BundleAssets);
+		for (UObject* Asset : BundleAssets)
+		{
+			if (Asset && Asset != MonsterData)
+			{
+				AssetBytes += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			}
+		}
+	}
+
+	ResidentBytes += AssetBytes;
+	SET_MEMORY_STAT(STAT_MonsterAssetsResident, ResidentBytes);
+
+	UE_LOG(LogTemp, Log, TEXT("MonsterAssetCache: Preloaded '%s' in %.2f ms (%lld KB)."), *MonsterId.ToString(), LoadTimeMs, AssetBytes / 1024);
+
+	OnMonsterReady.Broadcast(MonsterData);
+}
+
+USMonsterData* USMonsterAssetCache::FindLoadedMonster(const FPrimaryAssetId& MonsterId)
+{
+	USMonsterData** MonsterData = LoadedMonsters.Find(MonsterId);
+	if (MonsterData && *MonsterData)
+	{
+		NumCacheHits++;
+		INC_DWORD_STAT(STAT_MonsterCacheHits);
+		return *MonsterData;
+	}
+
+	NumCacheMisses++;
+	INC_DWORD_STAT(STAT_MonsterCacheMisses);
+	return nullptr;
+}
+
+bool USMonsterAssetCache::IsPreloadComplete() const
+{
+	return LoadedMonsters.Num() == PreloadHandles.Num();
+}
+
+void USMonsterAssetCache::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("MonsterAssetCache: %i/%i monsters resident (%lld KB), total load time %.2f ms, hits: %i, misses: %i."),
+		LoadedMonsters.Num(), PreloadHandles.Num(), ResidentBytes / 1024, TotalLoadTimeMs, NumCacheHits, NumCacheMisses);
+}
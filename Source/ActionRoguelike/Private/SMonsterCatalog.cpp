@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SMonsterCatalog.h"
+#include "SGameModeBase.h" // FMonsterInfoRow
+#include "Engine/DataTable.h"
+
+void FMonsterCatalog::Reset()
+{
+	Rows.Reset();
+	Probability.Reset();
+	Alias.Reset();
+}
+
+void FMonsterCatalog::Build(const UDataTable* MonsterTable)
+{
+	Reset();
+
+	if (MonsterTable == nullptr)
+	{
+		return;
+	}
+
+	TArray<FMonsterInfoRow*> AllRows;
+	MonsterTable->GetAllRows("", AllRows);
+
+	float TotalWeight = 0.0f;
+	for (FMonsterInfoRow* Row : AllRows)
+	{
+		if (Row && Row->MonsterId.IsValid() && Row->Weight > 0.0f)
+		{
+			Rows.Add(Row);
+			TotalWeight += Row->Weight;
+		}
+	}
+
+	const int32 NumRows = Rows.Num();
+	if (NumRows == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MonsterCatalog: '%s' has no spawnable rows (missing MonsterId or Weight <= 0)."), *GetNameSafe(MonsterTable));
+		return;
+	}
+
+	// Vose's alias method
+	// Scale every weight so the average becomes 1.0, then pair each 'small' column (< 1) with a 'large' one (>= 1) that fills up the rest of it.
+	Probability.SetNumUninitialized(NumRows);
+	Alias.SetNumUninitialized(NumRows);
+
+	TArray<float> Scaled;
+	Scaled.SetNumUninitialized(NumRows);
+
+	TArray<int32> Small;
+	TArray<int32> Large;
+	Small.Reserve(NumRows);
+	Large.Reserve(NumRows);
+
+	for (int32 i = 0; i < NumRows; i++)
+	{
+		Scaled[i] = Rows[i]->Weight * NumRows / TotalWeight;
+		Alias[i] = i;
+
+		if (Scaled[i] < 1.0f)
+		{
+			Small.Add(i);
+		}
+		else
+		{
+			Large.Add(i);
+		}
+	}
+
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		int32 SmallIndex = Small.Pop(false);
+		int32 LargeIndex = Large.Pop(false);
+
+		Probability[SmallIndex] = Scaled[SmallIndex];
+		Alias[SmallIndex] = LargeIndex;
+
+		// the large column donated (1 - small) of its weight
+		Scaled[LargeIndex] = (Scaled[LargeIndex] + Scaled[SmallIndex]) - 1.0f;
+		if (Scaled[LargeIndex] < 1.0f)
+		{
+			Small.Add(LargeIndex);
+		}
+		else
+		{
+			Large.Add(LargeIndex);
+		}
+	}
+
+	// Whatever is left is (within float precision) exactly 1.0
+	for (int32 Index : Large)
+	{
+		Probability[Index] = 1.0f;
+	}
+	for (int32 Index : Small)
+	{
+		Probability[Index] = 1.0f;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("MonsterCatalog: Compiled %i monster rows from '%s'."), NumRows, *GetNameSafe(MonsterTable));
+}
+
+const FMonsterInfoRow* FMonsterCatalog::PickRandomRow(const FRandomStream& RandomStream) const
+{
+	if (Rows.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Roll a column, then a biased coin to choose between the column and its alias
+	int32 Column = RandomStream.RandHelper(Rows.Num());
+	return RandomStream.GetFraction() < Probability[Column] ? Rows[Column] : Rows[Alias[Column]];
+}
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SPlacementGrid.h"
+
+FPlacementGrid::FPlacementGrid(float InMinDistance)
+{
+	Reset(InMinDistance);
+}
+
+void FPlacementGrid::Reset(float InMinDistance)
+{
+	MinDistance = FMath::Max(InMinDistance, 0.0f);
+	// A zero distance accepts everything, any cell size will do
+	InvCellSize = MinDistance > KINDA_SMALL_NUMBER ? 1.0f / MinDistance : 1.0f;
+
+	Points.Reset();
+	CellHeads.Reset();
+	NextInCell.Reset();
+}
+
+FIntVector FPlacementGrid::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X * InvCellSize),
+		FMath::FloorToInt(Location.Y * InvCellSize),
+		FMath::FloorToInt(Location.Z * InvCellSize));
+}
+
+bool FPlacementGrid::IsFarEnough(const FVector& Location) const
+{
+	if (MinDistance <= KINDA_SMALL_NUMBER || Points.Num() == 0)
+	{
+		return true;
+	}
+
+	const float MinDistanceSq = MinDistance * MinDistance;
+	const FIntVector Cell = GetCell(Location);
+
+	for (int32 X = -1; X <= 1; X++)
+	{
+		for (int32 Y = -1; Y <= 1; Y++)
+		{
+			for (int32 Z = -1; Z <= 1; Z++)
+			{
+				const int32* Head = CellHeads.Find(Cell + FIntVector(X, Y, Z));
+				for (int32 Index = Head ? *Head : INDEX_NONE; Index != INDEX_NONE; Index = NextInCell[Index])
+				{
+					if (FVector::DistSquared(Location, Points[Index]) < MinDistanceSq)
+					{
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FPlacementGrid::Add(const FVector& Location)
+{
+	int32 NewIndex = Points.Add(Location);
+
+	const FIntVector Cell = GetCell(Location);
+	int32* Head = CellHeads.Find(Cell);
+	if (Head)
+	{
+		NextInCell.Add(*Head);
+		*Head = NewIndex;
+	}
+	else
+	{
+		NextInCell.Add(INDEX_NONE);
+		CellHeads.Add(Cell, NewIndex);
+	}
+}
+
+bool FPlacementGrid::TryAdd(const FVector& Location)
+{
+	if (!IsFarEnough(Location))
+	{
+		return false;
+	}
+
+	Add(Location);
+	return true;
+}
+
+int32 FPlacementGrid::SelectLocations(TArray<FVector>& Candidates, float MinDistance, int32 MaxCount, const FRandomStream& RandomStream, TArray<FVector>& OutLocations)
+{
+	FPlacementGrid Grid(MinDistance);
+
+	// Break out if we reached the desired count or if we have no more potential positions remaining
+	while (Grid.Num() < MaxCount && Candidates.Num() > 0)
+	{
+		// Pick a random location from remaining points, swap-remove to avoid picking it again (no shifting of the remaining candidates)
+		int32 RandomIndex = RandomStream.RandHelper(Candidates.Num());
+		FVector PickedLocation = Candidates[RandomIndex];
+		Candidates.RemoveAtSwap(RandomIndex, 1, false);
+
+		Grid.TryAdd(PickedLocation);
+	}
+
+	OutLocations.Append(Grid.GetPoints());
+	return Grid.Num();
+}
@@ -4,6 +4,9 @@
 #include "SPlayerState.h"
 #include "SSaveGame.h"
 #include "Net/UnrealNetwork.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 
 void ASPlayerState::AddCredits(int32 Delta)
 {
@@ -39,21 +42,66 @@ bool ASPlayerState::RemoveCredits(int32 Delta)
 	return true;
 }
 
+FString ASPlayerState::GetSaveId() const
+{
+	if (UniqueId.IsValid())
+	{
+		return UniqueId.ToString();
+	}
+
+	return GetPlayerName();
+}
+
 void ASPlayerState::SavePlayerState_Implementation(USSaveGame* SaveObject)
 {
 	if (SaveObject)
 	{
-		SaveObject->Credits = Credits;
+		FPlayerSaveData& Record = SaveObject->FindOrAddPlayerData(GetSaveId());
+		Record.Credits = Credits;
 	}
 }
 
+void ASPlayerState::SerializeSaveData(FPlayerSaveData& Record)
+{
+	Record.ByteData.Reset();
+
+	FMemoryWriter MemWriter(Record.ByteData);
+	FObjectAndNameAsStringProxyArchive Ar(MemWriter, true);
+	Ar.ArIsSaveGame = true; // only UPROPERTY(SaveGame), see ASGameModeBase::SerializeActorForSave
+	Serialize(Ar);
+}
+
 void ASPlayerState::LoadPlayerState_Implementation(USSaveGame* SaveObject)
 {
-	if (SaveObject)
+	if (SaveObject == nullptr)
+	{
+		return;
+	}
+
+	int32 SavedCredits = 0;
+
+	const FPlayerSaveData* Record = SaveObject->FindPlayerData(GetSaveId());
+	if (Record)
+	{
+		SavedCredits = Record->Credits;
+
+		FMemoryReader MemReader(Record->ByteData);
+		FObjectAndNameAsStringProxyArchive Ar(MemReader, true);
+		Ar.ArIsSaveGame = true;
+		Serialize(Ar);
+	}
+	else if (SaveObject->Credits > 0)
+	{
+		// Save from before per player records, the first player to join gets its credits
+		SavedCredits = SaveObject->Credits;
+		SaveObject->Credits = 0;
+	}
+
+	if (SavedCredits > 0)
 	{
 		//Credits = SaveObject->Credits;
 		// Makes sure we trigger credits changed event
-		AddCredits(SaveObject->Credits);
+		AddCredits(SavedCredits);
 	}
 }
 
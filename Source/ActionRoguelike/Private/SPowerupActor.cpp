@@ -5,6 +5,8 @@
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "SGameModeBase.h"
+#include "SSaveGameRegistrySubsystem.h"
 
 ASPowerupActor::ASPowerupActor()
 {
@@ -24,6 +26,28 @@ ASPowerupActor::ASPowerupActor()
 }
 
 
+void ASPowerupActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->RegisterActor(this);
+	}
+}
+
+void ASPowerupActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ASPowerupActor::Interact_Implementation(APawn* InstigatorPawn)
 {
 	// logic in derived classes...
@@ -52,6 +76,12 @@ void ASPowerupActor::SetPowerupState(bool bNewIsActive)
 {
 	bIsActive = bNewIsActive;
 	OnRep_IsActive();
+
+	ASGameModeBase* GM = GetWorld()->GetAuthGameMode<ASGameModeBase>();
+	if (GM)
+	{
+		GM->MarkActorSaveDirty(this);
+	}
 }
 
 void ASPowerupActor::OnRep_IsActive()
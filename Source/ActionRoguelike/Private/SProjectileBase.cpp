@@ -10,6 +10,8 @@
 #include "Components/AudioComponent.h"
 #include "Sound/SoundCue.h"
 #include "Camera/CameraShake.h"
+#include "SProjectilePoolSubsystem.h"
+#include "Net/UnrealNetwork.h"
 
 ASProjectileBase::ASProjectileBase()
 {
@@ -33,6 +35,8 @@ ASProjectileBase::ASProjectileBase()
 	ImpactShakeInnerRadius = 250.0f;
 	ImpactShakeOuterRadius = 2500.0f;
 
+	bIsPooled = false;
+
 	SetReplicates(true);
 }
 
@@ -48,6 +52,12 @@ void ASProjectileBase::Explode_Implementation()
 {
 	// Check to make sure we aren't already being 'destroyed', hence avoiding spawning multiple particle effects
 	// Adding ensure to see if we encounter this situation at all
+	// Overlap and hit can both end up here in the same frame, the first one already returned us to the pool
+	if (bIsPooled)
+	{
+		return;
+	}
+
 	if (ensure(!IsPendingKill()))
 	{
 		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactVFX, GetActorLocation(), GetActorRotation());
@@ -59,6 +69,111 @@ void ASProjectileBase::Explode_Implementation()
 		MoveComp->StopMovementImmediately();
 		SetActorEnableCollision(false);
 
+		ReturnToPool();
+	}
+}
+
+
+void ASProjectileBase::ReturnToPool()
+{
+	if (!HasAuthority())
+	{
+		// The pool lives on the server, stop our local copy until the server either reuses or destroys it
+		DeactivateForPool();
+		return;
+	}
+
+	USProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<USProjectilePoolSubsystem>();
+	if (ProjectilePool)
+	{
+		ProjectilePool->ReleaseProjectile(this);
+	}
+	else
+	{
 		Destroy();
 	}
+}
+
+
+void ASProjectileBase::LifeSpanExpired()
+{
+	// Skip Super, it would Destroy() us
+	ReturnToPool();
+}
+
+
+void ASProjectileBase::DeactivateForPool()
+{
+	bIsPooled = true;
+
+	// Clears the lifespan timer plus anything child classes may have pending (e.g. DashProjectile detonate)
+	SetLifeSpan(0.0f);
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	MoveComp->StopMovementImmediately();
+	EffectComp->DeactivateSystem();
+	AudioComp->Stop();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+
+void ASProjectileBase::ActivateFromPool(const FTransform& SpawnTM, APawn* NewInstigator)
+{
+	// Also undoes a parry, which hands the projectile over to the parrying pawn mid-flight (see ASMagicProjectile::OnActorOverlap)
+	SetInstigator(NewInstigator);
+
+	SetActorLocationAndRotation(SpawnTM.GetLocation(), SpawnTM.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	LaunchInfo.Location = SpawnTM.GetLocation();
+	LaunchInfo.Rotation = SpawnTM.Rotator();
+	LaunchInfo.ReuseCount++;
+
+	Launch();
+
+	ForceNetUpdate();
+}
+
+
+void ASProjectileBase::Launch()
+{
+	bIsPooled = false;
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// Blocking hits stop the simulation which clears the UpdatedComponent (UProjectileMovementComponent::StopSimulating)
+	MoveComp->SetUpdatedComponent(RootComponent);
+	// Same as spawning with bInitialVelocityInLocalSpace, a parry may have reversed the old velocity
+	MoveComp->Velocity = GetActorForwardVector() * MoveComp->InitialSpeed;
+	MoveComp->UpdateComponentVelocity();
+
+	EffectComp->ActivateSystem(true);
+	AudioComp->Play();
+
+	SetLifeSpan(InitialLifeSpan);
+}
+
+
+void ASProjectileBase::OnRep_LaunchInfo()
+{
+	// Server reused this projectile, relaunch our local simulation from where it was fired
+	SetActorLocationAndRotation(LaunchInfo.Location, LaunchInfo.Rotation, false, nullptr, ETeleportType::ResetPhysics);
+
+	Launch();
+}
+
+
+bool ASProjectileBase::IsPooled() const
+{
+	return bIsPooled;
+}
+
+
+void ASProjectileBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASProjectileBase, LaunchInfo);
 }
\ No newline at end of file
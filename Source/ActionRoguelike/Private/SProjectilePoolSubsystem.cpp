@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SProjectilePoolSubsystem.h"
+#include "SProjectileBase.h"
+#include "../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Hits"), STAT_ProjectilePoolHits, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Misses"), STAT_ProjectilePoolMisses, STATGROUP_STANFORD);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Projectiles"), STAT_PooledProjectiles, STATGROUP_STANFORD);
+
+void USProjectilePoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumPoolHits = 0;
+	NumPoolMisses = 0;
+}
+
+void USProjectilePoolSubsystem::Deinitialize()
+{
+	for (auto& Entry : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_PooledProjectiles, Entry.Value.Projectiles.Num());
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AActor* USProjectilePoolSubsystem::AcquireProjectile(UClass* ProjectileClass, const FTransform& SpawnTM, APawn* InstigatorPawn)
+{
+	if (!ensure(ProjectileClass))
+	{
+		return nullptr;
+	}
+
+	FProjectilePoolBucket* Bucket = Pools.Find(ProjectileClass);
+	while (Bucket && Bucket->Projectiles.Num() > 0)
+	{
+		ASProjectileBase* Projectile = Bucket->Projectiles.Pop(false);
+		DEC_DWORD_STAT(STAT_PooledProjectiles);
+
+		// Could have been destroyed by something else (e.g. level streaming) while sitting in the pool
+		if (IsValid(Projectile))
+		{
+			Projectile->ActivateFromPool(SpawnTM, InstigatorPawn);
+
+			NumPoolHits++;
+			INC_DWORD_STAT(STAT_ProjectilePoolHits);
+			return Projectile;
+		}
+	}
+
+	NumPoolMisses++;
+	INC_DWORD_STAT(STAT_ProjectilePoolMisses);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Instigator = InstigatorPawn; // avoid projectiles damaging whoever fired them (there is an instigator check inside SMagicProjectile)
+
+	return GetWorld()->SpawnActor<AActor>(ProjectileClass, SpawnTM, SpawnParams);
+}
+
+void USProjectilePoolSubsystem::ReleaseProjectile(ASProjectileBase* Projectile)
+{
+	if (!ensure(Projectile) || Projectile->IsPooled())
+	{
+		return;
+	}
+
+	Projectile->DeactivateForPool();
+
+	Pools.FindOrAdd(Projectile->GetClass()).Projectiles.Add(Projectile);
+	INC_DWORD_STAT(STAT_PooledProjectiles);
+}
+
+int32 USProjectilePoolSubsystem::GetNumPooledProjectiles(UClass* ProjectileClass) const
+{
+	const FProjectilePoolBucket* Bucket = Pools.Find(ProjectileClass);
+	return Bucket ? Bucket->Projectiles.Num() : 0;
+}
+
+void USProjectilePoolSubsystem::LogStats() const
+{
+	for (const auto& Entry : Pools)
+	{
+		UE_LOG(LogTemp, Log, TEXT("ProjectilePool: %s : %i pooled."), *GetNameSafe(Entry.Key), Entry.Value.Projectiles.Num());
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ProjectilePool: hits: %i, misses: %i."), NumPoolHits, NumPoolMisses);
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SRandomSubsystem.h"
+
+const FName USRandomSubsystem::MonsterSpawnChannel = "MonsterSpawn";
+const FName USRandomSubsystem::PowerupsChannel = "Powerups";
+const FName USRandomSubsystem::CombatChannel = "Combat";
+
+void USRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Until GameMode assigns the real one (and for worlds without a GameMode, e.g. clients)
+	FRandomStream SeedStream;
+	SeedStream.GenerateNewSeed();
+	MatchSeed = SeedStream.GetInitialSeed();
+}
+
+int32 USRandomSubsystem::MakeChannelSeed(FName Channel) const
+{
+	// FName hashes depend on the name table and differ between runs, the string CRC does not
+	return (int32)HashCombine((uint32)MatchSeed, FCrc::StrCrc32(*Channel.ToString()));
+}
+
+void USRandomSubsystem::SetMatchSeed(int32 NewSeed)
+{
+	MatchSeed = NewSeed;
+
+	for (auto& Entry : Streams)
+	{
+		Entry.Value.Initialize(MakeChannelSeed(Entry.Key));
+	}
+}
+
+FRandomStream& USRandomSubsystem::GetStream(FName Channel)
+{
+	FRandomStream* Stream = Streams.Find(Channel);
+	if (Stream)
+	{
+		return *Stream;
+	}
+
+	return Streams.Add(Channel, FRandomStream(MakeChannelSeed(Channel)));
+}
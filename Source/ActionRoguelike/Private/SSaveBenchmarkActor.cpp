@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSaveBenchmarkActor.h"
+#include "Components/SceneComponent.h"
+#include "SSaveGameRegistrySubsystem.h"
+
+ASSaveBenchmarkActor::ASSaveBenchmarkActor()
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>("RootComp");
+
+	Counter = 0;
+	Value = 0.0f;
+	bFlag = false;
+	Offset = FVector::ZeroVector;
+	LoadedChecksum = 0;
+}
+
+void ASSaveBenchmarkActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->RegisterActor(this);
+	}
+}
+
+void ASSaveBenchmarkActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	USSaveGameRegistrySubsystem* SaveRegistry = GetWorld()->GetSubsystem<USSaveGameRegistrySubsystem>();
+	if (SaveRegistry)
+	{
+		SaveRegistry->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASSaveBenchmarkActor::Randomize(FRandomStream& Stream)
+{
+	Counter = Stream.RandRange(0, 1000);
+	Value = Stream.FRand();
+	bFlag = Stream.FRand() > 0.5f;
+	Tag = Stream.FRand() > 0.5f ? FName("Opened") : FName("Closed");
+	Offset = Stream.VRand() * 100.0f;
+
+	History.SetNum(Stream.RandRange(0, 8));
+	for (int32& Entry : History)
+	{
+		Entry = Stream.RandRange(0, 100);
+	}
+}
+
+void ASSaveBenchmarkActor::OnActorLoaded_Implementation()
+{
+	LoadedChecksum = Counter + History.Num() + (bFlag ? 1 : 0);
+}
@@ -3,3 +3,75 @@
 
 #include "SSaveGame.h"
 
+
+void USSaveGame::BuildActorIndex()
+{
+	ActorIndex.Empty(SavedActors.Num());
+
+	for (int32 i = 0; i < SavedActors.Num(); i++)
+	{
+		ActorIndex.Add(SavedActors[i].ActorName, i);
+	}
+}
+
+const FActorSaveData* USSaveGame::FindActorData(FName ActorName) const
+{
+	const int32* Index = ActorIndex.Find(ActorName);
+	if (Index)
+	{
+		return &SavedActors[*Index];
+	}
+
+	return nullptr;
+}
+
+FActorSaveData& USSaveGame::FindOrAddActorData(FName ActorName)
+{
+	const int32* Index = ActorIndex.Find(ActorName);
+	if (Index)
+	{
+		return SavedActors[*Index];
+	}
+
+	int32 NewIndex = SavedActors.AddDefaulted();
+	SavedActors[NewIndex].ActorName = ActorName;
+	ActorIndex.Add(ActorName, NewIndex);
+
+	return SavedActors[NewIndex];
+}
+
+bool USSaveGame::RemoveActorData(FName ActorName)
+{
+	int32 Index = INDEX_NONE;
+	if (!ActorIndex.RemoveAndCopyValue(ActorName, Index))
+	{
+		return false;
+	}
+
+	// Move the last entry into the gap, only its index changes
+	SavedActors.RemoveAtSwap(Index, 1, false);
+	if (SavedActors.IsValidIndex(Index))
+	{
+		ActorIndex.Add(SavedActors[Index].ActorName, Index);
+	}
+
+	return true;
+}
+
+const FPlayerSaveData* USSaveGame::FindPlayerData(const FString& PlayerId) const
+{
+	return SavedPlayers.FindByPredicate([&PlayerId](const FPlayerSaveData& Data) { return Data.PlayerId == PlayerId; });
+}
+
+FPlayerSaveData& USSaveGame::FindOrAddPlayerData(const FString& PlayerId)
+{
+	FPlayerSaveData* Data = SavedPlayers.FindByPredicate([&PlayerId](const FPlayerSaveData& Entry) { return Entry.PlayerId == PlayerId; });
+	if (Data)
+	{
+		return *Data;
+	}
+
+	FPlayerSaveData& NewData = SavedPlayers.AddDefaulted_GetRef();
+	NewData.PlayerId = PlayerId;
+	return NewData;
+}
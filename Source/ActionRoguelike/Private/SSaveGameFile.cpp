@@ -0,0 +1,560 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSaveGameFile.h"
+#include "Kismet/GameplayStatics.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/Compression.h"
+
+// "SRSG", tells our files apart from the ones written by UGameplayStatics::SaveGameToSlot (those start with "GVAS")
+static const uint32 SaveFileMagic = 0x47535253;
+
+// 1 : initial
+// 2 : actor names are FNames (layout unchanged, version 1 files still load)
+// 3 : section table, chunked actors, quantized transforms
+// 4 : per player records in the player section
+static const int32 SaveFileVersion = 4;
+
+// Section ids, "PLYR" and "ACTR"
+static const uint32 PlayerSectionId = 0x52594C50;
+static const uint32 ActorsSectionId = 0x52544341;
+
+/* Entry in the section table right after the file header */
+struct FSaveFileSection
+{
+	uint32 Id = 0;
+
+	/* From the start of the file */
+	int32 Offset = 0;
+
+	/* Bytes in the file, equal to RawSize for sections that were not worth compressing */
+	int32 StoredSize = 0;
+
+	int32 RawSize = 0;
+
+	uint8 bCompressed = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FSaveFileSection& Section)
+	{
+		Ar << Section.Id;
+		Ar << Section.Offset;
+		Ar << Section.StoredSize;
+		Ar << Section.RawSize;
+		Ar << Section.bCompressed;
+		return Ar;
+	}
+};
+
+/* Section while it's being written, data is moved into the file once the table is known */
+struct FSaveFileChunk
+{
+	uint32 Id;
+
+	TArray<uint8> RawData;
+
+	TArray<uint8> StoredData;
+
+	bool bCompressed;
+};
+
+static void CompressChunk(FSaveFileChunk& Chunk)
+{
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Chunk.RawData.Num());
+	Chunk.StoredData.SetNumUninitialized(CompressedSize);
+
+	// Tiny chunks (e.g. player section) tend to grow, keep those as they are
+	Chunk.bCompressed = FCompression::CompressMemory(NAME_Zlib, Chunk.StoredData.GetData(), CompressedSize, Chunk.RawData.GetData(), Chunk.RawData.Num())
+		&& CompressedSize < Chunk.RawData.Num();
+
+	if (Chunk.bCompressed)
+	{
+		Chunk.StoredData.SetNum(CompressedSize, false);
+	}
+	else
+	{
+		Chunk.StoredData = Chunk.RawData;
+	}
+}
+
+void FSaveGameFile::SerializeQuantizedTransform(FArchive& Ar, FTransform& Transform)
+{
+	// 19 bytes for the common case instead of 40 for a full FTransform
+	int32 LocationX = 0;
+	int32 LocationY = 0;
+	int32 LocationZ = 0;
+	uint16 Pitch = 0;
+	uint16 Yaw = 0;
+	uint16 Roll = 0;
+	uint8 bHasScale = 0;
+	FVector Scale = FVector::OneVector;
+
+	if (Ar.IsSaving())
+	{
+		FVector Location = Transform.GetLocation();
+		LocationX = FMath::RoundToInt(Location.X * 100.0f);
+		LocationY = FMath::RoundToInt(Location.Y * 100.0f);
+		LocationZ = FMath::RoundToInt(Location.Z * 100.0f);
+
+		FRotator Rotation = Transform.Rotator();
+		Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+		Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+		Roll = FRotator::CompressAxisToShort(Rotation.Roll);
+
+		Scale = Transform.GetScale3D();
+		bHasScale = !Scale.Equals(FVector::OneVector) ? 1 : 0;
+	}
+
+	Ar << LocationX;
+	Ar << LocationY;
+	Ar << LocationZ;
+	Ar << Pitch;
+	Ar << Yaw;
+	Ar << Roll;
+	Ar << bHasScale;
+	if (bHasScale)
+	{
+		Ar << Scale;
+	}
+
+	if (Ar.IsLoading())
+	{
+		FRotator Rotation(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), FRotator::DecompressAxisFromShort(Roll));
+		FVector Location(LocationX / 100.0f, LocationY / 100.0f, LocationZ / 100.0f);
+
+		Transform = FTransform(Rotation, Location, Scale);
+	}
+}
+
+void FSaveGameFile::SerializeActor(FArchive& Ar, FActorSaveData& ActorData)
+{
+	// Memory archives write FNames as plain strings
+	Ar << ActorData.ActorName;
+	SerializeQuantizedTransform(Ar, ActorData.Transform);
+	Ar << ActorData.ByteData;
+}
+
+void FSaveGameFile::SerializePlayer(FArchive& Ar, FPlayerSaveData& PlayerData)
+{
+	Ar << PlayerData.PlayerId;
+	Ar << PlayerData.Credits;
+	Ar << PlayerData.ByteData;
+}
+
+void FSaveGameFile::MakeSnapshot(const USSaveGame* SaveGame, FSaveGameSnapshot& OutSnapshot)
+{
+	OutSnapshot.Credits = SaveGame->Credits;
+	OutSnapshot.SavedPlayers = SaveGame->SavedPlayers;
+	OutSnapshot.SavedActors = SaveGame->SavedActors;
+}
+
+bool FSaveGameFile::WriteToMemory(FSaveGameSnapshot& Snapshot, TArray<uint8>& OutFileData, FSaveGameWriteResult& OutResult)
+{
+	double StartTime = FPlatformTime::Seconds();
+
+	TArray<FSaveFileChunk> Chunks;
+
+	{
+		FSaveFileChunk& PlayerChunk = Chunks.AddDefaulted_GetRef();
+		PlayerChunk.Id = PlayerSectionId;
+
+		FMemoryWriter Writer(PlayerChunk.RawData);
+		Writer << Snapshot.Credits;
+
+		int32 NumPlayers = Snapshot.SavedPlayers.Num();
+		Writer << NumPlayers;
+
+		for (FPlayerSaveData& PlayerData : Snapshot.SavedPlayers)
+		{
+			SerializePlayer(Writer, PlayerData);
+		}
+	}
+
+	for (int32 FirstActor = 0; FirstActor < Snapshot.SavedActors.Num(); FirstActor += ActorsPerChunk)
+	{
+		FSaveFileChunk& ActorChunk = Chunks.AddDefaulted_GetRef();
+		ActorChunk.Id = ActorsSectionId;
+
+		int32 NumActors = FMath::Min(ActorsPerChunk, Snapshot.SavedActors.Num() - FirstActor);
+
+		FMemoryWriter Writer(ActorChunk.RawData);
+		Writer << NumActors;
+
+		for (int32 i = FirstActor; i < FirstActor + NumActors; i++)
+		{
+			SerializeActor(Writer, Snapshot.SavedActors[i]);
+		}
+	}
+
+	double SerializedTime = FPlatformTime::Seconds();
+
+	int32 UncompressedSize = 0;
+	for (FSaveFileChunk& Chunk : Chunks)
+	{
+		UncompressedSize += Chunk.RawData.Num();
+		CompressChunk(Chunk);
+	}
+
+	double CompressedTime = FPlatformTime::Seconds();
+
+	uint32 Magic = SaveFileMagic;
+	int32 Version = SaveFileVersion;
+	int32 NumSections = Chunks.Num();
+
+	TArray<FSaveFileSection> Sections;
+	Sections.SetNum(NumSections);
+
+	// Table size is fixed, so all offsets are known before writing it
+	int32 HeaderSize = sizeof(uint32) + sizeof(int32) + sizeof(int32) + NumSections * (sizeof(uint32) + 3 * sizeof(int32) + sizeof(uint8));
+	int32 Offset = HeaderSize;
+	for (int32 i = 0; i < NumSections; i++)
+	{
+		Sections[i].Id = Chunks[i].Id;
+		Sections[i].Offset = Offset;
+		Sections[i].StoredSize = Chunks[i].StoredData.Num();
+		Sections[i].RawSize = Chunks[i].RawData.Num();
+		Sections[i].bCompressed = Chunks[i].bCompressed ? 1 : 0;
+
+		Offset += Sections[i].StoredSize;
+	}
+
+	OutFileData.Reset(Offset);
+
+	FMemoryWriter FileWriter(OutFileData);
+	FileWriter << Magic;
+	FileWriter << Version;
+	FileWriter << NumSections;
+	for (FSaveFileSection& Section : Sections)
+	{
+		FileWriter << Section;
+	}
+
+	check(OutFileData.Num() == HeaderSize);
+
+	for (FSaveFileChunk& Chunk : Chunks)
+	{
+		OutFileData.Append(Chunk.StoredData);
+	}
+
+	OutResult.SerializeMs = (SerializedTime - StartTime) * 1000.0;
+	OutResult.CompressMs = (CompressedTime - SerializedTime) * 1000.0;
+	OutResult.UncompressedBytes = UncompressedSize;
+	OutResult.CompressedBytes = OutFileData.Num();
+
+	return true;
+}
+
+void FSaveGameFile::Write(FSaveGameSnapshot& Snapshot, const FString& SlotName, int32 UserIndex, FSaveGameWriteResult& OutResult)
+{
+	TArray<uint8> FileData;
+	if (!WriteToMemory(Snapshot, FileData, OutResult))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Failed to pack save data for slot '%s'."), *SlotName);
+		return;
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	OutResult.bSuccess = SaveSystem && SaveSystem->SaveGame(false, *SlotName, UserIndex, FileData);
+
+	OutResult.WriteMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+bool FSaveGameFile::ReadSlot(const FString& SlotName, int32 UserIndex, TArray<uint8>& OutFileData)
+{
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	return SaveSystem && SaveSystem->LoadGame(false, *SlotName, UserIndex, OutFileData);
+}
+
+USSaveGame* FSaveGameFile::Load(const FString& SlotName, int32 UserIndex, ESaveGameSections Sections)
+{
+	TArray<uint8> FileData;
+	if (!ReadSlot(SlotName, UserIndex, FileData))
+	{
+		return nullptr;
+	}
+
+	return LoadFromMemory(FileData, Sections, SlotName);
+}
+
+USSaveGame* FSaveGameFile::LoadFromMemory(const TArray<uint8>& FileData, ESaveGameSections Sections, const FString& DebugName)
+{
+	FSaveGameSnapshot Snapshot;
+	bool bEngineFormat = false;
+
+	if (!ReadSnapshot(FileData, Sections, Snapshot, DebugName, bEngineFormat))
+	{
+		// Written by the old synchronous SaveGameToSlot path
+		return bEngineFormat ? Cast<USSaveGame>(UGameplayStatics::LoadGameFromMemory(FileData)) : nullptr;
+	}
+
+	USSaveGame* SaveGame = Cast<USSaveGame>(UGameplayStatics::CreateSaveGameObject(USSaveGame::StaticClass()));
+	ApplySnapshot(Snapshot, SaveGame, Sections);
+
+	return SaveGame;
+}
+
+void FSaveGameFile::ApplySnapshot(FSaveGameSnapshot& Snapshot, USSaveGame* SaveGame, ESaveGameSections Sections)
+{
+	if (EnumHasAnyFlags(Sections, ESaveGameSections::Player))
+	{
+		SaveGame->Credits = Snapshot.Credits;
+		SaveGame->SavedPlayers = MoveTemp(Snapshot.SavedPlayers);
+	}
+
+	if (EnumHasAnyFlags(Sections, ESaveGameSections::Actors))
+	{
+		SaveGame->SavedActors = MoveTemp(Snapshot.SavedActors);
+	}
+}
+
+bool FSaveGameFile::ReadSnapshot(const TArray<uint8>& FileData, ESaveGameSections Sections, FSaveGameSnapshot& OutSnapshot, const FString& DebugName, bool& bOutEngineFormat)
+{
+	FMemoryReader FileReader(FileData);
+
+	uint32 Magic = 0;
+	if (FileData.Num() >= (int32)sizeof(uint32))
+	{
+		FileReader << Magic;
+	}
+
+	bOutEngineFormat = Magic != SaveFileMagic;
+	if (bOutEngineFormat)
+	{
+		return false;
+	}
+
+	int32 Version = 0;
+	FileReader << Version;
+
+	if (FileReader.IsError() || Version > SaveFileVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' has an unknown version (%i)."), *DebugName, Version);
+		return false;
+	}
+
+	if (Version < 3)
+	{
+		return LoadSingleBlob(FileReader, FileData, OutSnapshot, DebugName);
+	}
+
+	int32 NumSections = 0;
+	FileReader << NumSections;
+
+	TArray<FSaveFileSection> SectionTable;
+	if (NumSections >= 0 && NumSections <= FileData.Num())
+	{
+		SectionTable.SetNum(NumSections);
+		for (FSaveFileSection& Section : SectionTable)
+		{
+			FileReader << Section;
+		}
+	}
+
+	if (FileReader.IsError() || SectionTable.Num() != NumSections)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' has a corrupt section table."), *DebugName);
+		return false;
+	}
+
+	TArray<uint8> RawData;
+
+	for (const FSaveFileSection& Section : SectionTable)
+	{
+		bool bWanted = (Section.Id == PlayerSectionId && EnumHasAnyFlags(Sections, ESaveGameSections::Player))
+			|| (Section.Id == ActorsSectionId && EnumHasAnyFlags(Sections, ESaveGameSections::Actors));
+
+		// Unknown ids are from newer builds adding sections, skip those too
+		if (!bWanted)
+		{
+			continue;
+		}
+
+		if (Section.Offset < 0 || Section.StoredSize < 0 || Section.RawSize < 0 || Section.StoredSize > FileData.Num() - Section.Offset)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' is truncated."), *DebugName);
+			return false;
+		}
+
+		const uint8* StoredData = FileData.GetData() + Section.Offset;
+
+		RawData.Reset();
+		if (Section.bCompressed)
+		{
+			RawData.SetNumUninitialized(Section.RawSize);
+			if (!FCompression::UncompressMemory(NAME_Zlib, RawData.GetData(), Section.RawSize, StoredData, Section.StoredSize))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("SaveGame: Failed to decompress slot '%s'."), *DebugName);
+				return false;
+			}
+		}
+		else
+		{
+			RawData.Append(StoredData, Section.StoredSize);
+		}
+
+		FMemoryReader SectionReader(RawData);
+
+		if (Section.Id == PlayerSectionId)
+		{
+			SectionReader << OutSnapshot.Credits;
+
+			int32 NumPlayers = 0;
+			if (Version >= 4)
+			{
+				SectionReader << NumPlayers;
+			}
+
+			if (NumPlayers < 0 || NumPlayers > Section.RawSize)
+			{
+				SectionReader.SetError();
+			}
+			else
+			{
+				OutSnapshot.SavedPlayers.SetNum(NumPlayers);
+				for (FPlayerSaveData& PlayerData : OutSnapshot.SavedPlayers)
+				{
+					SerializePlayer(SectionReader, PlayerData);
+				}
+			}
+		}
+		else
+		{
+			int32 NumActors = 0;
+			SectionReader << NumActors;
+
+			if (NumActors < 0 || NumActors > ActorsPerChunk)
+			{
+				SectionReader.SetError();
+			}
+			else
+			{
+				int32 FirstActor = OutSnapshot.SavedActors.AddDefaulted(NumActors);
+				for (int32 i = FirstActor; i < FirstActor + NumActors; i++)
+				{
+					SerializeActor(SectionReader, OutSnapshot.SavedActors[i]);
+				}
+			}
+		}
+
+		if (SectionReader.IsError())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' is corrupt."), *DebugName);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FSaveGameFile::LoadSingleBlob(FArchive& FileReader, const TArray<uint8>& FileData, FSaveGameSnapshot& OutSnapshot, const FString& DebugName)
+{
+	int32 UncompressedSize = 0;
+	int32 CompressedSize = 0;
+	FileReader << UncompressedSize;
+	FileReader << CompressedSize;
+
+	if (FileReader.IsError() || UncompressedSize < 0 || CompressedSize < 0 || CompressedSize > FileData.Num() - FileReader.Tell())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' is truncated."), *DebugName);
+		return false;
+	}
+
+	TArray<uint8> Uncompressed;
+	Uncompressed.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), UncompressedSize, FileData.GetData() + FileReader.Tell(), CompressedSize))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Failed to decompress slot '%s'."), *DebugName);
+		return false;
+	}
+
+	FMemoryReader PayloadReader(Uncompressed);
+	PayloadReader << OutSnapshot.Credits;
+
+	int32 NumActors = 0;
+	PayloadReader << NumActors;
+
+	if (NumActors >= 0 && NumActors <= UncompressedSize)
+	{
+		OutSnapshot.SavedActors.SetNum(NumActors);
+		for (FActorSaveData& ActorData : OutSnapshot.SavedActors)
+		{
+			PayloadReader << ActorData.ActorName;
+			PayloadReader << ActorData.Transform;
+			PayloadReader << ActorData.ByteData;
+		}
+	}
+
+	if (PayloadReader.IsError() || OutSnapshot.SavedActors.Num() != NumActors)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveGame: Slot '%s' is corrupt."), *DebugName);
+		return false;
+	}
+
+	return true;
+}
+
+void FSaveGameFile::LogFormatComparison(USSaveGame* SaveGame, int32 NumIterations)
+{
+	if (SaveGame == nullptr || NumIterations <= 0)
+	{
+		return;
+	}
+
+	FSaveGameSnapshot Snapshot;
+	MakeSnapshot(SaveGame, Snapshot);
+
+	TArray<uint8> LegacyData;
+	TArray<uint8> FileData;
+	FSaveGameWriteResult Result;
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumIterations; i++)
+	{
+		LegacyData.Reset();
+		UGameplayStatics::SaveGameToMemory(SaveGame, LegacyData);
+	}
+	double LegacyWriteMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumIterations; i++)
+	{
+		UGameplayStatics::LoadGameFromMemory(LegacyData);
+	}
+	double LegacyReadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumIterations; i++)
+	{
+		WriteToMemory(Snapshot, FileData, Result);
+	}
+	double WriteMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumIterations; i++)
+	{
+		LoadFromMemory(FileData, ESaveGameSections::All, TEXT("FormatComparison"));
+	}
+	double ReadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+	// Loading just the credits, e.g. for a main menu slot preview
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumIterations; i++)
+	{
+		LoadFromMemory(FileData, ESaveGameSections::Player, TEXT("FormatComparison"));
+	}
+	double ReadPlayerMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+
+	// MB/s is relative to our uncompressed save data for both formats, so the numbers are comparable
+	double DataMB = Result.UncompressedBytes / (1024.0 * 1024.0);
+	auto Throughput = [DataMB](double Ms) { return Ms > 0.0 ? DataMB / (Ms / 1000.0) : 0.0; };
+
+	UE_LOG(LogTemp, Log, TEXT("SaveGameFormat: %i actors, %i iterations."), Snapshot.SavedActors.Num(), NumIterations);
+	UE_LOG(LogTemp, Log, TEXT("SaveGameFormat: SaveGameToMemory : %i bytes, write %.3f ms (%.1f MB/s), read %.3f ms (%.1f MB/s)."),
+		LegacyData.Num(), LegacyWriteMs, Throughput(LegacyWriteMs), LegacyReadMs, Throughput(LegacyReadMs));
+	UE_LOG(LogTemp, Log, TEXT("SaveGameFormat: Version %i : %i bytes (%i uncompressed), write %.3f ms (%.1f MB/s), read %.3f ms (%.1f MB/s), player section only %.3f ms."),
+		SaveFileVersion, FileData.Num(), Result.UncompressedBytes, WriteMs, Throughput(WriteMs), ReadMs, Throughput(ReadMs), ReadPlayerMs);
+}
@@ -0,0 +1,6 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSaveGameInterface.h"
+
+// Add default functionality here for any ISSaveGameInterface functions that are not pure virtual.
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSaveGameRegistrySubsystem.h"
+#include "SSaveGameInterface.h"
+#include "../ActionRoguelike.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SaveGame Registered Actors"), STAT_SaveGameRegisteredActors, STATGROUP_STANFORD);
+
+void USSaveGameRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bNeedsSort = false;
+}
+
+void USSaveGameRegistrySubsystem::RegisterActor(AActor* Actor)
+{
+	if (!ensure(Actor) || !ensureMsgf(Actor->Implements<USSaveGameInterface>(), TEXT("%s does not implement SSaveGameInterface."), *GetNameSafe(Actor)))
+	{
+		return;
+	}
+
+	if (ActorPriorities.Contains(Actor)) // already registered
+	{
+		return;
+	}
+
+	ActorPriorities.Add(Actor, ISSaveGameInterface::Execute_GetSavePriority(Actor));
+	bNeedsSort = true;
+
+	INC_DWORD_STAT(STAT_SaveGameRegisteredActors);
+
+	OnActorRegistered.Broadcast(Actor);
+}
+
+void USSaveGameRegistrySubsystem::UnregisterActor(AActor* Actor)
+{
+	if (ActorPriorities.Remove(Actor) == 0)
+	{
+		return;
+	}
+
+	// Order is restored by the next GetActors
+	bNeedsSort = true;
+
+	DEC_DWORD_STAT(STAT_SaveGameRegisteredActors);
+
+	OnActorUnregistered.Broadcast(Actor);
+}
+
+int32 USSaveGameRegistrySubsystem::GetNumActors() const
+{
+	return ActorPriorities.Num();
+}
+
+const TArray<AActor*>& USSaveGameRegistrySubsystem::GetActors()
+{
+	if (bNeedsSort)
+	{
+		// Name as tie breaker so actors with equal priority are saved in the same order every run, saves stay comparable
+		ActorPriorities.KeySort([](const AActor* A, const AActor* B) { return A->GetFName().LexicalLess(B->GetFName()); });
+		ActorPriorities.ValueStableSort([](int32 A, int32 B) { return A > B; });
+
+		SortedActors.Reset(ActorPriorities.Num());
+		ActorPriorities.GenerateKeyArray(SortedActors);
+
+		bNeedsSort = false;
+	}
+
+	return SortedActors;
+}
+
+void USSaveGameRegistrySubsystem::LogStats() const
+{
+	struct FClassStats
+	{
+		int32 Count = 0;
+		int32 Priority = 0;
+	};
+
+	TMap<UClass*, FClassStats> ClassStats;
+	for (const auto& Entry : ActorPriorities)
+	{
+		if (Entry.Key)
+		{
+			FClassStats& Stats = ClassStats.FindOrAdd(Entry.Key->GetClass());
+			Stats.Count++;
+			Stats.Priority = Entry.Value;
+		}
+	}
+
+	for (const auto& Pair : ClassStats)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SaveGameRegistry: %s : %i registered, priority %i."), *GetNameSafe(Pair.Key), Pair.Value.Count, Pair.Value.Priority);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SaveGameRegistry: %i actors registered."), ActorPriorities.Num());
+}
+
+void USSaveGameRegistrySubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_SaveGameRegisteredActors, ActorPriorities.Num());
+
+	ActorPriorities.Empty();
+	SortedActors.Empty();
+
+	Super::Deinitialize();
+}
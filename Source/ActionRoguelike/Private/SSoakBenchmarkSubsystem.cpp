@@ -0,0 +1,368 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SSoakBenchmarkSubsystem.h"
+#include "AI/SBotRegistrySubsystem.h"
+#include "AI/SAICharacter.h"
+#include "SActionComponent.h"
+#include "SAttributeComponent.h"
+#include "SRandomSubsystem.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+#include "TimerManager.h"
+
+// Declared next to the bot spawning in SGameModeBase.cpp
+static IConsoleVariable* FindForceBotCountCVar()
+{
+	return IConsoleManager::Get().FindConsoleVariable(TEXT("su.ForceBotCount"));
+}
+
+/* Average, percentiles and max of Values as a JSON object */
+static FString MakeMetricJson(TArray<float> Values)
+{
+	if (Values.Num() == 0)
+	{
+		return TEXT("{}");
+	}
+
+	Values.Sort();
+
+	float Sum = 0.0f;
+	for (float Value : Values)
+	{
+		Sum += Value;
+	}
+
+	auto Percentile = [&Values](float Fraction)
+	{
+		int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	};
+
+	return FString::Printf(TEXT("{ \"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f }"),
+		Sum / Values.Num(), Percentile(0.5f), Percentile(0.95f), Percentile(0.99f), Values.Last());
+}
+
+void USSoakBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TargetBots = 0;
+	Duration = 60.0f;
+	MaxWarmUpTime = 120.0f;
+	NumScriptedPlayers = 4;
+	FireInterval = 0.5f;
+	bRunning = false;
+	bExitWhenDone = false;
+	bSampling = false;
+	bHasLastFrame = false;
+	WorldTickStartCycles = 0;
+	PostTickDispatchCycles = 0;
+	PostActorTickCycles = 0;
+	LastWorldTickMs = 0.0f;
+	LastNetMs = 0.0f;
+}
+
+void USSoakBenchmarkSubsystem::Deinitialize()
+{
+	UnbindTickDelegates();
+
+	Super::Deinitialize();
+}
+
+void USSoakBenchmarkSubsystem::UnbindTickDelegates()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	if (UWorld* World = GetWorld())
+	{
+		World->OnPostTickDispatch().Remove(PostTickDispatchHandle);
+		World->OnPostTickFlush().Remove(PostTickFlushHandle);
+	}
+
+	WorldTickStartHandle.Reset();
+	PostTickDispatchHandle.Reset();
+	PostActorTickHandle.Reset();
+	PostTickFlushHandle.Reset();
+}
+
+void USSoakBenchmarkSubsystem::StartFromCommandLine()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	int32 NumBots = 0;
+	if (bRunning || !FParse::Value(CommandLine, TEXT("SoakBots="), NumBots) || NumBots <= 0)
+	{
+		return;
+	}
+
+	float RunDuration = Duration;
+	int32 NumPlayers = NumScriptedPlayers;
+	FString Name;
+	FParse::Value(CommandLine, TEXT("SoakDuration="), RunDuration);
+	FParse::Value(CommandLine, TEXT("SoakWarmUp="), MaxWarmUpTime);
+	FParse::Value(CommandLine, TEXT("SoakPlayers="), NumPlayers);
+	FParse::Value(CommandLine, TEXT("SoakFireInterval="), FireInterval);
+	FParse::Value(CommandLine, TEXT("SoakName="), Name);
+
+	bExitWhenDone = true;
+	StartRun(NumBots, RunDuration, NumPlayers, Name);
+}
+
+void USSoakBenchmarkSubsystem::StartRun(int32 InTargetBots, float InDuration, int32 InNumScriptedPlayers, const FString& InRunName)
+{
+	if (bRunning || InTargetBots <= 0)
+	{
+		return;
+	}
+
+	TargetBots = InTargetBots;
+	Duration = InDuration;
+	NumScriptedPlayers = InNumScriptedPlayers;
+	RunName = InRunName.IsEmpty() ? FString::Printf(TEXT("Soak_%i"), TargetBots) : InRunName;
+
+	UE_LOG(LogTemp, Log, TEXT("SoakBenchmark: Starting '%s' : %i bots, %i scripted players, %.0f seconds."), *RunName, TargetBots, NumScriptedPlayers, Duration);
+
+	bRunning = true;
+	StartTime = FPlatformTime::Seconds();
+
+	// GameMode keeps this many bots alive, ignoring difficulty and spawn points
+	IConsoleVariable* ForceBotCountVar = FindForceBotCountCVar();
+	if (ensure(ForceBotCountVar))
+	{
+		ForceBotCountVar->Set(TargetBots);
+	}
+
+	SpawnScriptedPlayers();
+
+	UWorld* World = GetWorld();
+	World->GetTimerManager().SetTimer(TimerHandle_Fire, this, &USSoakBenchmarkSubsystem::FireScriptedPlayers, FireInterval, true);
+	World->GetTimerManager().SetTimer(TimerHandle_WarmUp, this, &USSoakBenchmarkSubsystem::CheckWarmUp, 1.0f, true);
+
+	// Order within UWorld::Tick : TickStart -> (net) TickDispatch -> PostTickDispatch -> actor ticks -> PostActorTick -> (net) TickFlush -> PostTickFlush
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &USSoakBenchmarkSubsystem::OnWorldTickStart);
+	PostTickDispatchHandle = World->OnPostTickDispatch().AddUObject(this, &USSoakBenchmarkSubsystem::OnPostTickDispatch);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &USSoakBenchmarkSubsystem::OnWorldPostActorTick);
+	PostTickFlushHandle = World->OnPostTickFlush().AddUObject(this, &USSoakBenchmarkSubsystem::OnPostTickFlush);
+}
+
+void USSoakBenchmarkSubsystem::SpawnScriptedPlayers()
+{
+	UWorld* World = GetWorld();
+	AGameModeBase* GameMode = World->GetAuthGameMode();
+	if (!ensure(GameMode) || GameMode->DefaultPawnClass == nullptr)
+	{
+		return;
+	}
+
+	AActor* PlayerStart = GameMode->FindPlayerStart(nullptr);
+	FVector Origin = PlayerStart ? PlayerStart->GetActorLocation() : FVector::ZeroVector;
+
+	for (int32 i = 0; i < NumScriptedPlayers; i++)
+	{
+		// Spread them in a circle around the player start so they don't block each other's shots
+		FVector Offset = FRotator(0.0f, 360.0f * i / NumScriptedPlayers, 0.0f).Vector() * 200.0f;
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		APawn* Pawn = World->SpawnActor<APawn>(GameMode->DefaultPawnClass, Origin + Offset, FRotator::ZeroRotator, SpawnParams);
+		if (Pawn == nullptr)
+		{
+			continue;
+		}
+
+		// Plain AIController (APawn::AIControllerClass), we drive it ourselves in FireScriptedPlayers
+		Pawn->SpawnDefaultController();
+		if (Pawn->GetController())
+		{
+			ScriptedPlayers.Add(Pawn->GetController());
+		}
+	}
+}
+
+void USSoakBenchmarkSubsystem::FireScriptedPlayers()
+{
+	USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+	const TArray<ASAICharacter*>& AliveBots = BotRegistry->GetAliveBots();
+	if (AliveBots.Num() == 0)
+	{
+		return;
+	}
+
+	FRandomStream& CombatStream = GetWorld()->GetSubsystem<USRandomSubsystem>()->GetStream(USRandomSubsystem::CombatChannel);
+
+	for (AController* Controller : ScriptedPlayers)
+	{
+		APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		if (Pawn == nullptr || !USAttributeComponent::IsActorAlive(Pawn))
+		{
+			continue;
+		}
+
+		// Aim at a random bot, USAction_ProjectileAttack traces along the control rotation
+		AActor* Target = AliveBots[CombatStream.RandHelper(AliveBots.Num())];
+		Controller->SetControlRotation((Target->GetActorLocation() - Pawn->GetActorLocation()).Rotation());
+
+		USActionComponent* ActionComp = Cast<USActionComponent>(Pawn->GetComponentByClass(USActionComponent::StaticClass()));
+		if (ActionComp)
+		{
+			ActionComp->StartActionByName(Pawn, "PrimaryAttack");
+		}
+	}
+}
+
+void USSoakBenchmarkSubsystem::CheckWarmUp()
+{
+	USBotRegistrySubsystem* BotRegistry = GetWorld()->GetSubsystem<USBotRegistrySubsystem>();
+	int32 NumAliveBots = BotRegistry->GetNumAliveBots();
+
+	float WarmUpTime = FPlatformTime::Seconds() - StartTime;
+
+	// Kills by the scripted players keep the count slightly below target, don't wait for an exact match
+	bool bReachedTarget = NumAliveBots >= FMath::FloorToInt(TargetBots * 0.9f);
+	if (!bReachedTarget && WarmUpTime < MaxWarmUpTime)
+	{
+		return;
+	}
+
+	if (!bReachedTarget)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SoakBenchmark: Only reached %i/%i bots after %.0f seconds, sampling anyway."), NumAliveBots, TargetBots, WarmUpTime);
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_WarmUp);
+	BeginSampling();
+}
+
+void USSoakBenchmarkSubsystem::BeginSampling()
+{
+	UE_LOG(LogTemp, Log, TEXT("SoakBenchmark: Warmed up after %.1f seconds, sampling for %.0f seconds."), FPlatformTime::Seconds() - StartTime, Duration);
+
+	Samples.Reset();
+	Samples.Reserve(FMath::CeilToInt(Duration * 120));
+	bSampling = true;
+	bHasLastFrame = false;
+	SampleStartTime = FPlatformTime::Seconds();
+
+	// Engine side breakdown (physics, AI, net categories etc.) ends up in Saved/Profiling/CSV
+	GEngine->Exec(GetWorld(), TEXT("CsvProfile Start"));
+
+	FTimerHandle TimerHandle_Finish;
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle_Finish, this, &USSoakBenchmarkSubsystem::FinishRun, Duration);
+}
+
+void USSoakBenchmarkSubsystem::FinishRun()
+{
+	bSampling = false;
+	bRunning = false;
+
+	GEngine->Exec(GetWorld(), TEXT("CsvProfile Stop"));
+
+	GetWorld()->GetTimerManager().ClearTimer(TimerHandle_Fire);
+
+	// Another run may follow in the same world (automation test), it binds them again
+	UnbindTickDelegates();
+
+	IConsoleVariable* ForceBotCountVar = FindForceBotCountCVar();
+	if (ForceBotCountVar)
+	{
+		ForceBotCountVar->Set(0);
+	}
+
+	WriteResults();
+
+	// Not when driven by the automation test, it checks the results itself and runs the next size
+	if (bExitWhenDone && FApp::IsUnattended())
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void USSoakBenchmarkSubsystem::WriteResults() const
+{
+	FString BaseFileName = FPaths::ProfilingDir() / TEXT("Soak") / FString::Printf(TEXT("%s_%s"), *RunName, *FDateTime::Now().ToString());
+
+	TArray<float> FrameMs, GameThreadMs, WorldTickMs, NetMs, AliveBots;
+
+	FString Csv = TEXT("Frame,FrameMs,GameThreadMs,WorldTickMs,NetMs,AliveBots\n");
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const FSoakFrameSample& Sample = Samples[i];
+		Csv += FString::Printf(TEXT("%i,%.3f,%.3f,%.3f,%.3f,%i\n"), i, Sample.FrameMs, Sample.GameThreadMs, Sample.WorldTickMs, Sample.NetMs, Sample.AliveBots);
+
+		FrameMs.Add(Sample.FrameMs);
+		GameThreadMs.Add(Sample.GameThreadMs);
+		WorldTickMs.Add(Sample.WorldTickMs);
+		NetMs.Add(Sample.NetMs);
+		AliveBots.Add(Sample.AliveBots);
+	}
+
+	FString Json = FString::Printf(TEXT("{\n  \"name\": \"%s\",\n  \"map\": \"%s\",\n  \"targetBots\": %i,\n  \"scriptedPlayers\": %i,\n  \"duration\": %.1f,\n  \"frames\": %i,\n"),
+		*RunName, *GetWorld()->GetMapName(), TargetBots, NumScriptedPlayers, Duration, Samples.Num());
+	Json += FString::Printf(TEXT("  \"frameMs\": %s,\n"), *MakeMetricJson(FrameMs));
+	Json += FString::Printf(TEXT("  \"gameThreadMs\": %s,\n"), *MakeMetricJson(GameThreadMs));
+	Json += FString::Printf(TEXT("  \"worldTickMs\": %s,\n"), *MakeMetricJson(WorldTickMs));
+	Json += FString::Printf(TEXT("  \"netMs\": %s,\n"), *MakeMetricJson(NetMs));
+	Json += FString::Printf(TEXT("  \"aliveBots\": %s\n}\n"), *MakeMetricJson(AliveBots));
+
+	FFileHelper::SaveStringToFile(Csv, *(BaseFileName + TEXT(".csv")));
+	FFileHelper::SaveStringToFile(Json, *(BaseFileName + TEXT(".json")));
+
+	UE_LOG(LogTemp, Log, TEXT("SoakBenchmark: Wrote %i frames to '%s.csv/.json'."), Samples.Num(), *BaseFileName);
+	UE_LOG(LogTemp, Log, TEXT("SoakBenchmark: gameThreadMs %s"), *MakeMetricJson(GameThreadMs));
+}
+
+void USSoakBenchmarkSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// GGameThreadTime (and our world timings) now describe the previous frame
+	if (bSampling && bHasLastFrame)
+	{
+		USBotRegistrySubsystem* BotRegistry = World->GetSubsystem<USBotRegistrySubsystem>();
+
+		FSoakFrameSample Sample;
+		Sample.FrameMs = FApp::GetDeltaTime() * 1000.0f;
+		Sample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		Sample.WorldTickMs = LastWorldTickMs;
+		Sample.NetMs = LastNetMs;
+		Sample.AliveBots = BotRegistry->GetNumAliveBots();
+		Samples.Add(Sample);
+	}
+
+	WorldTickStartCycles = FPlatformTime::Cycles();
+}
+
+void USSoakBenchmarkSubsystem::OnPostTickDispatch()
+{
+	PostTickDispatchCycles = FPlatformTime::Cycles();
+}
+
+void USSoakBenchmarkSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	PostActorTickCycles = FPlatformTime::Cycles();
+}
+
+void USSoakBenchmarkSubsystem::OnPostTickFlush()
+{
+	uint32 NowCycles = FPlatformTime::Cycles();
+
+	LastWorldTickMs = FPlatformTime::ToMilliseconds(PostActorTickCycles - PostTickDispatchCycles);
+	LastNetMs = FPlatformTime::ToMilliseconds(PostTickDispatchCycles - WorldTickStartCycles) + FPlatformTime::ToMilliseconds(NowCycles - PostActorTickCycles);
+	bHasLastFrame = true;
+}
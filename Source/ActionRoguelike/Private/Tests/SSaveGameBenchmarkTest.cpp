@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "SGameModeBase.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<float> CVarSaveBenchmarkMaxMsPerActor(TEXT("su.SaveBenchmarkMaxMsPerActor"), 0.0f, TEXT("Fail the SaveGame.Benchmark automation test when save + load + restore take longer than this per actor. 0 = only report."), ECVF_Cheat);
+
+// Headless : UE4Editor-Cmd ActionRoguelike -ExecCmds="Automation RunTests ActionRoguelike.SaveGame.Benchmark; Quit" -nullrhi -unattended
+// One test per world size, each runs ASGameModeBase::RunSaveBenchmark in a fresh world holding nothing but the benchmark actors.
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FSaveGameBenchmarkTest, "ActionRoguelike.SaveGame.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FSaveGameBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const int32 Sizes[] = { 1000, 10000, 50000 };
+	for (int32 NumActors : Sizes)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%i Actors"), NumActors));
+		OutTestCommands.Add(FString::FromInt(NumActors));
+	}
+}
+
+bool FSaveGameBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumActors = FCString::Atoi(*Parameters);
+	if (!TestTrue(TEXT("Actor count parameter"), NumActors > 0))
+	{
+		return false;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SaveBenchmarkWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+	// No GameMode in here, start play on the world directly so spawned actors get BeginPlay (and register with the save registry)
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	FSaveBenchmarkResult Result;
+	ASGameModeBase::RunSaveBenchmark(World, NumActors, Result);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	TestTrue(TEXT("Save loaded back"), Result.bLoaded);
+	TestEqual(TEXT("Actors saved"), Result.NumSaved, NumActors);
+	TestEqual(TEXT("Actors restored"), Result.NumRestored, NumActors);
+	TestTrue(TEXT("Bytes written"), Result.BytesWritten > 0);
+
+	AddInfo(FString::Printf(TEXT("serialize %.2f ms, snapshot %.2f ms, pack %.2f ms, compress %.2f ms, write %.2f ms, load %.2f ms, index %.2f ms, restore %.2f ms"),
+		Result.SerializeMs, Result.SnapshotMs, Result.PackMs, Result.CompressMs, Result.WriteMs, Result.LoadMs, Result.IndexMs, Result.RestoreMs));
+	AddInfo(FString::Printf(TEXT("%i bytes written (%i uncompressed), peak memory +%.1f MB"), Result.BytesWritten, Result.UncompressedBytes, Result.PeakMemoryDeltaMB));
+	AddInfo(FString::Printf(TEXT("CSV : %s / %s"), FSaveBenchmarkResult::CsvHeader, *Result.ToCsvRow()));
+
+	const float MaxMsPerActor = CVarSaveBenchmarkMaxMsPerActor.GetValueOnGameThread();
+	if (MaxMsPerActor > 0.0f)
+	{
+		double TotalMs = Result.SerializeMs + Result.SnapshotMs + Result.PackMs + Result.CompressMs + Result.WriteMs + Result.LoadMs + Result.IndexMs + Result.RestoreMs;
+		double MsPerActor = TotalMs / NumActors;
+		TestTrue(*FString::Printf(TEXT("%.4f ms per actor within budget of %.4f ms"), MsPerActor, MaxMsPerActor), MsPerActor <= MaxMsPerActor);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "SSaveGameFile.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Run from the Session Frontend or with : -ExecCmds="Automation RunTests ActionRoguelike.SaveGame"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaveGameFileRoundTripTest, "ActionRoguelike.SaveGame.FileRoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSaveGameFileRoundTripTest::RunTest(const FString& Parameters)
+{
+	// Fixed seed so a failure can be reproduced
+	FRandomStream Stream(1337);
+
+	FSaveGameSnapshot Snapshot;
+	Snapshot.Credits = 42;
+
+	for (int32 i = 0; i < 3; i++)
+	{
+		FPlayerSaveData PlayerData;
+		PlayerData.PlayerId = FString::Printf(TEXT("Player_%i"), i);
+		PlayerData.Credits = Stream.RandRange(0, 1000);
+		PlayerData.ByteData.SetNumUninitialized(Stream.RandRange(0, 64));
+		for (uint8& Byte : PlayerData.ByteData)
+		{
+			Byte = (uint8)Stream.RandRange(0, 255);
+		}
+		Snapshot.SavedPlayers.Add(MoveTemp(PlayerData));
+	}
+
+	// More than one chunk, and a partial last one
+	const int32 NumActors = FSaveGameFile::ActorsPerChunk * 2 + 17;
+	for (int32 i = 0; i < NumActors; i++)
+	{
+		FActorSaveData ActorData;
+		ActorData.ActorName = FName(TEXT("SaveTestActor"), i);
+
+		FRotator Rotation(Stream.FRandRange(-89.0f, 89.0f), Stream.FRandRange(-180.0f, 180.0f), Stream.FRandRange(-180.0f, 180.0f));
+		FVector Location(Stream.FRandRange(-10000.0f, 10000.0f), Stream.FRandRange(-10000.0f, 10000.0f), Stream.FRandRange(-1000.0f, 1000.0f));
+		// Most actors are unscaled, that case is written without the scale
+		FVector Scale = (i % 4 == 0) ? FVector(Stream.FRandRange(0.5f, 2.0f)) : FVector::OneVector;
+		ActorData.Transform = FTransform(Rotation, Location, Scale);
+
+		ActorData.ByteData.SetNumUninitialized(Stream.RandRange(0, 128));
+		for (uint8& Byte : ActorData.ByteData)
+		{
+			Byte = (uint8)Stream.RandRange(0, 255);
+		}
+		Snapshot.SavedActors.Add(MoveTemp(ActorData));
+	}
+
+	TArray<uint8> FileData;
+	FSaveGameWriteResult WriteResult;
+	if (!TestTrue(TEXT("WriteToMemory succeeds"), FSaveGameFile::WriteToMemory(Snapshot, FileData, WriteResult)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("CompressedBytes matches the file size"), WriteResult.CompressedBytes, FileData.Num());
+
+	FSaveGameSnapshot Loaded;
+	bool bEngineFormat = false;
+	if (!TestTrue(TEXT("ReadSnapshot succeeds"), FSaveGameFile::ReadSnapshot(FileData, ESaveGameSections::All, Loaded, TEXT("FileRoundTrip"), bEngineFormat)))
+	{
+		return false;
+	}
+	TestFalse(TEXT("Our own format is not reported as engine format"), bEngineFormat);
+
+	TestEqual(TEXT("Credits"), Loaded.Credits, Snapshot.Credits);
+
+	if (TestEqual(TEXT("Number of players"), Loaded.SavedPlayers.Num(), Snapshot.SavedPlayers.Num()))
+	{
+		for (int32 i = 0; i < Snapshot.SavedPlayers.Num(); i++)
+		{
+			const FPlayerSaveData& Expected = Snapshot.SavedPlayers[i];
+			const FPlayerSaveData& Actual = Loaded.SavedPlayers[i];
+			TestEqual(TEXT("PlayerId"), Actual.PlayerId, Expected.PlayerId);
+			TestEqual(TEXT("Player credits"), Actual.Credits, Expected.Credits);
+			TestTrue(*FString::Printf(TEXT("ByteData of %s"), *Expected.PlayerId), Actual.ByteData == Expected.ByteData);
+		}
+	}
+
+	if (TestEqual(TEXT("Number of actors"), Loaded.SavedActors.Num(), Snapshot.SavedActors.Num()))
+	{
+		for (int32 i = 0; i < Snapshot.SavedActors.Num(); i++)
+		{
+			const FActorSaveData& Expected = Snapshot.SavedActors[i];
+			const FActorSaveData& Actual = Loaded.SavedActors[i];
+			const FString ActorName = Expected.ActorName.ToString();
+
+			TestTrue(*FString::Printf(TEXT("ActorName of %s"), *ActorName), Actual.ActorName == Expected.ActorName);
+
+			// Transforms are quantized : 1/100 cm location and 16 bit rotation axes (~0.0055 degrees)
+			TestTrue(*FString::Printf(TEXT("Location of %s"), *ActorName), Actual.Transform.GetLocation().Equals(Expected.Transform.GetLocation(), 0.01f));
+			float AngleDelta = FMath::RadiansToDegrees(Actual.Transform.GetRotation().AngularDistance(Expected.Transform.GetRotation()));
+			TestTrue(*FString::Printf(TEXT("Rotation of %s (off by %.4f degrees)"), *ActorName, AngleDelta), AngleDelta < 0.05f);
+			TestTrue(*FString::Printf(TEXT("Scale of %s"), *ActorName), Actual.Transform.GetScale3D().Equals(Expected.Transform.GetScale3D()));
+
+			TestTrue(*FString::Printf(TEXT("ByteData of %s"), *ActorName), Actual.ByteData == Expected.ByteData);
+		}
+	}
+
+	// Sections not asked for must be left out
+	FSaveGameSnapshot PlayersOnly;
+	if (TestTrue(TEXT("ReadSnapshot (players only) succeeds"), FSaveGameFile::ReadSnapshot(FileData, ESaveGameSections::Player, PlayersOnly, TEXT("FileRoundTrip"), bEngineFormat)))
+	{
+		TestEqual(TEXT("Players only : number of players"), PlayersOnly.SavedPlayers.Num(), Snapshot.SavedPlayers.Num());
+		TestEqual(TEXT("Players only : no actors"), PlayersOnly.SavedActors.Num(), 0);
+	}
+
+	// Truncated files must be rejected, not read past the end
+	TArray<uint8> Truncated(FileData.GetData(), FileData.Num() / 2);
+	FSaveGameSnapshot TruncatedSnapshot;
+	AddExpectedError(TEXT("is truncated"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("ReadSnapshot rejects a truncated file"), FSaveGameFile::ReadSnapshot(Truncated, ESaveGameSections::All, TruncatedSnapshot, TEXT("FileRoundTrip"), bEngineFormat));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+#include "SSoakBenchmarkSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SoakBenchmarkTest
+{
+	/* The world the game is playing in (standalone or PIE) */
+	static UWorld* GetGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+			{
+				return Context.World();
+			}
+		}
+
+		return nullptr;
+	}
+
+	static USSoakBenchmarkSubsystem* GetSoakBenchmark()
+	{
+		UWorld* World = GetGameWorld();
+		return World ? World->GetSubsystem<USSoakBenchmarkSubsystem>() : nullptr;
+	}
+}
+
+/* Opens MapName (a fresh world per run, even if it is already loaded) and waits until it began play */
+class FOpenSoakMapCommand : public IAutomationLatentCommand
+{
+public:
+
+	FOpenSoakMapCommand(FAutomationTestBase* InTest, const FString& InMapName)
+		: Test(InTest)
+		, MapName(InMapName)
+		, bOpenSent(false)
+	{
+	}
+
+	virtual ~FOpenSoakMapCommand()
+	{
+		FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	}
+
+	virtual bool Update() override
+	{
+		if (!bOpenSent)
+		{
+			PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([this](UWorld* World) { LoadedWorld = World; });
+			GEngine->Exec(SoakBenchmarkTest::GetGameWorld(), *FString::Printf(TEXT("Open %s"), *MapName));
+			bOpenSent = true;
+			return false;
+		}
+
+		if (LoadedWorld.IsValid() && LoadedWorld->HasBegunPlay())
+		{
+			return true;
+		}
+
+		if (GetCurrentRunTime() > 120.0)
+		{
+			Test->AddError(FString::Printf(TEXT("Timed out loading '%s'."), *MapName));
+			return true;
+		}
+
+		return false;
+	}
+
+private:
+
+	FAutomationTestBase* Test;
+
+	FString MapName;
+
+	bool bOpenSent;
+
+	TWeakObjectPtr<UWorld> LoadedWorld;
+
+	FDelegateHandle PostLoadMapHandle;
+};
+
+DEFINE_LATENT_AUTOMATION_COMMAND_FOUR_PARAMETER(FStartSoakRunCommand, FAutomationTestBase*, Test, int32, NumBots, float, Duration, int32, NumPlayers);
+
+bool FStartSoakRunCommand::Update()
+{
+	USSoakBenchmarkSubsystem* SoakBenchmark = SoakBenchmarkTest::GetSoakBenchmark();
+	if (SoakBenchmark == nullptr || SoakBenchmark->GetWorld()->GetNetMode() == NM_Client)
+	{
+		Test->AddError(TEXT("No server game world to run the soak benchmark in."));
+		return true;
+	}
+
+	SoakBenchmark->StartRun(NumBots, Duration, NumPlayers, FString::Printf(TEXT("SoakTest_%i"), NumBots));
+	return true;
+}
+
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FWaitForSoakRunCommand, FAutomationTestBase*, Test, float, Timeout);
+
+bool FWaitForSoakRunCommand::Update()
+{
+	USSoakBenchmarkSubsystem* SoakBenchmark = SoakBenchmarkTest::GetSoakBenchmark();
+	if (SoakBenchmark == nullptr)
+	{
+		Test->AddError(TEXT("World went away during the soak run."));
+		return true;
+	}
+
+	if (SoakBenchmark->IsRunning())
+	{
+		if (GetCurrentRunTime() > Timeout)
+		{
+			Test->AddError(FString::Printf(TEXT("Soak run did not finish within %.0f seconds."), Timeout));
+			return true;
+		}
+		return false;
+	}
+
+	Test->TestTrue(TEXT("Frames sampled"), SoakBenchmark->GetNumSamples() > 0);
+	Test->AddInfo(FString::Printf(TEXT("%i frames sampled, CSV and JSON summary in Saved/Profiling/Soak."), SoakBenchmark->GetNumSamples()));
+	return true;
+}
+
+// Headless, on a Linux box without GPU :
+// UE4Editor ActionRoguelike -game -nullrhi -unattended -ExecCmds="Automation RunTests ActionRoguelike.Soak; Quit"
+// The map needs a NavMesh for the bots to move, -SoakMap=/Game/Maps/<BenchmarkMap> to pick another one. -SoakDuration= and -SoakPlayers= apply as well.
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FSoakBenchmarkTest, "ActionRoguelike.Soak", EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::PerfFilter)
+
+void FSoakBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const int32 BotCounts[] = { 50, 200, 500 };
+	for (int32 NumBots : BotCounts)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%i Bots"), NumBots));
+		OutTestCommands.Add(FString::FromInt(NumBots));
+	}
+}
+
+bool FSoakBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 NumBots = FCString::Atoi(*Parameters);
+	if (!TestTrue(TEXT("Bot count parameter"), NumBots > 0))
+	{
+		return false;
+	}
+
+	FString MapName = TEXT("/Game/Maps/TestLevel");
+	float Duration = 60.0f;
+	int32 NumPlayers = 4;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakMap="), MapName);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakDuration="), Duration);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakPlayers="), NumPlayers);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FOpenSoakMapCommand(this, MapName));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartSoakRunCommand(this, NumBots, Duration, NumPlayers));
+	// Warm-up (up to 120 seconds by default) + sampling + writing the results
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForSoakRunCommand(this, Duration + 180.0f));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -11,6 +11,8 @@ class USAttributeComponent;
 class UUserWidget;
 class USWorldUserWidget;
 class USActionComponent;
+class USBotRegistrySubsystem;
+class USBotPoolSubsystem;
 
 UCLASS()
 class ACTIONROGUELIKE_API ASAICharacter : public ACharacter
@@ -49,6 +51,39 @@ protected:
 
 	virtual void PostInitializeComponents() override;
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void UnregisterFromBotRegistry();
+
+	/* Time the ragdoll stays around after death, before the bot is returned to the pool (or destroyed if there is no pool) */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float RagdollDuration;
+
+	FTimerHandle TimerHandle_ReturnToPool;
+
+	void ReturnToPool();
+
+	bool bIsPooled;
+
+	/* Incremented every time the bot is reused, lets clients know they need to undo the ragdoll */
+	UPROPERTY(ReplicatedUsing = "OnRep_ReuseCount")
+	uint8 ReuseCount;
+
+	UFUNCTION()
+	void OnRep_ReuseCount();
+
+	/* Undo everything done to the body when dying (ragdoll, disabled capsule and movement) */
+	void RestoreBodyAfterRagdoll();
+
+	void RemoveHealthBar();
+
+	// Original mesh setup, restored when reusing a ragdolled bot
+	FTransform MeshRelativeTransform;
+	FName MeshCollisionProfileName;
+	ECollisionEnabled::Type CapsuleCollisionEnabled;
+
 	UFUNCTION()
 	void OnHealthChanged(AActor* InstigatorActor, USAttributeComponent* OwningComp, float NewHealth, float Delta);
 
@@ -66,4 +101,21 @@ protected:
 
 	UFUNCTION(NetMulticast, Unreliable)
 	void MulticastPawnSeen();
+
+public:
+
+	// Called by USBotPoolSubsystem only
+
+	void DeactivateForPool();
+
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation);
+
+	bool IsPooled() const;
+
+private:
+
+	/* Slot inside USBotRegistrySubsystem::AliveBots, INDEX_NONE while not registered. Managed by the registry only. */
+	int32 BotRegistryIndex;
+
+	friend class USBotRegistrySubsystem;
 };
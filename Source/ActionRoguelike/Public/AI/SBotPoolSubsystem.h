@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SBotPoolSubsystem.generated.h"
+
+class ASAICharacter;
+
+USTRUCT()
+struct FBotPoolBucket
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Deactivated bots of a single class, waiting to be reused */
+	UPROPERTY()
+	TArray<ASAICharacter*> Bots;
+};
+
+/**
+ * Recycles dead bots instead of destroying them and spawning brand new actors (+ AI controllers) for every spawn.
+ * Dead bots are handed back after their ragdoll window (see ASAICharacter::ReturnToPool) and reused by ASGameModeBase::SpawnMonster.
+ * Server only, clients just see the replicated result.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USBotPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Keyed by bot class, an exact match is required to reuse a bot */
+	UPROPERTY()
+	TMap<UClass*, FBotPoolBucket> Pools;
+
+	/* Outstanding warm-up requests, processed a few spawns per frame to avoid a hitch */
+	TArray<TPair<TSubclassOf<ASAICharacter>, int32>> PendingWarmUps;
+
+	/* Max bots spawned for warm-up in a single frame */
+	int32 WarmUpSpawnsPerFrame;
+
+	FTimerHandle TimerHandle_WarmUp;
+
+	int32 NumPoolHits;
+
+	int32 NumPoolMisses;
+
+	void ProcessWarmUp();
+
+public:
+
+	/* Reactivate a pooled bot of exactly BotClass at the given location. Returns nullptr on a pool miss, caller is expected to spawn a new one. */
+	ASAICharacter* AcquireBot(UClass* BotClass, const FVector& Location, const FRotator& Rotation);
+
+	/* Deactivate and store the bot for later reuse */
+	void ReleaseBot(ASAICharacter* Bot);
+
+	/* Make sure at least Count bots of this class are sitting in the pool. Bots are spawned over the next frames. */
+	void RequestWarmUp(TSubclassOf<AActor> BotClass, int32 Count);
+
+	int32 GetNumPooledBots(UClass* BotClass) const;
+
+	void LogStats() const;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};
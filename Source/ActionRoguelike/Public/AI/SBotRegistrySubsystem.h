@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SBotRegistrySubsystem.generated.h"
+
+class ASAICharacter;
+
+/**
+ * Keeps track of all alive bots in the world.
+ * Bots register themselves on BeginPlay and unregister on death/EndPlay,
+ * so GameMode (and any other system) never needs to iterate the whole actor list with TActorIterator to find them.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USBotRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Contiguous list of alive bots. Order is NOT stable, removal swaps the last bot into the freed slot. */
+	UPROPERTY()
+	TArray<ASAICharacter*> AliveBots;
+
+public:
+
+	void RegisterBot(ASAICharacter* Bot);
+
+	void UnregisterBot(ASAICharacter* Bot);
+
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	int32 GetNumAliveBots() const;
+
+	const TArray<ASAICharacter*>& GetAliveBots() const;
+
+	virtual void Deinitialize() override;
+};
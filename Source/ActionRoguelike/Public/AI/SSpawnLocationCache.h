@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+#include "SSpawnLocationCache.generated.h"
+
+class UEnvQuery;
+class UEnvQueryInstanceBlueprintWrapper;
+
+/**
+ * Runs the bot spawn EQS query once and keeps the best scoring candidates around,
+ * so waves can grab spawn locations right away instead of running (and waiting on) a query every time.
+ * The set is refreshed in the background when it runs low or when players moved too far away from where it was queried,
+ * the old candidates keep being handed out until the new results are in.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USSpawnLocationCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	UPROPERTY()
+	UEnvQuery* SpawnQuery;
+
+	UPROPERTY()
+	UObject* Querier;
+
+	/* Best scoring results of the last query. Only the first NumAvailable are still unused. */
+	TArray<FVector> Candidates;
+
+	int32 NumAvailable;
+
+	/* Player locations at the time of the last query */
+	TArray<FVector> QueriedPlayerLocations;
+
+	/* Refresh once any player moved further than this from where the candidates were queried */
+	float RefreshDistance;
+
+	/* Refresh once fewer candidates than this are left */
+	int32 MinAvailable;
+
+	/* Share of the (sorted) results kept as candidates, same idea as EEnvQueryRunMode::RandomBest5Pct */
+	float BestCandidateFraction;
+
+	bool bQueryInFlight;
+
+	/* After a failed or empty query, wait this long before trying again instead of querying every spawn tick */
+	float RetryCooldown;
+
+	/* World time before which no new query is started (see RetryCooldown) */
+	float NextQueryTime;
+
+	int32 NumQueries;
+
+	int32 NumLocationsHandedOut;
+
+	void GatherPlayerLocations(TArray<FVector>& OutLocations) const;
+
+	bool HavePlayersMoved() const;
+
+	/* Fewer than MinAvailable left, or fewer than the last query found at all (it won't find more next time) */
+	bool IsRunningLow() const;
+
+	UFUNCTION()
+	void OnSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrapper* QueryInstance, EEnvQueryStatus::Type QueryStatus);
+
+public:
+
+	/* Assign the query to cache (GameMode calls this on StartPlay) and kick off the first refresh */
+	void Setup(UEnvQuery* InSpawnQuery, UObject* InQuerier, float InRefreshDistance, int32 InMinAvailable);
+
+	/* Start a refresh if players moved too far or we are running low. Cheap, meant to be called every spawn tick. */
+	void UpdateCache();
+
+	/* Run the query again, no-op if one is already running */
+	void RequestRefresh();
+
+	int32 GetNumAvailable() const { return NumAvailable; }
+
+	/* Hand out up to Count distinct random candidates, returns how many were added to OutLocations */
+	int32 TakeLocations(int32 Count, const FRandomStream& RandomStream, TArray<FVector>& OutLocations);
+
+	void LogStats() const;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+};
@@ -9,6 +9,7 @@
 
 class UWorld;
 class USActionComponent;
+struct FActionListEntry;
 
 USTRUCT()
 struct FActionRepData
@@ -38,7 +39,8 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI")
 	TSoftObjectPtr<UTexture2D> Icon;
 
-	UPROPERTY(Replicated)
+	// Set on server and clients alike (USActionComponent::AddAction or when a client receives the action)
+	UPROPERTY()
 	USActionComponent* ActionComp;
 
 	UFUNCTION(BlueprintCallable, Category = "Action")
@@ -75,13 +77,13 @@ protected:
 
 	// Making a struct with 2 values instead of simply adding a second replicated value (e.g. the Instigator), 
 	// ensures that both values will arrive at the same time.
-	UPROPERTY(ReplicatedUsing = "OnRep_RepData")
+	// Replicated through the owning component's ActionList (see ApplyRepState), OnRep_RepData still only runs when the value differs from ours.
+	UPROPERTY()
 	FActionRepData RepData;
 
-	UFUNCTION()
 	void OnRep_RepData();
 
-	UPROPERTY(Replicated)
+	UPROPERTY()
 	float TimeStarted;
 
 public:
@@ -92,6 +94,26 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Action")
 	bool bAutoStart;
 
+	// Reuse this object after it was removed from its component (see USActionComponent::ActionPools) instead of leaving it to GC.
+	// Off by default, only safe if ResetAction puts back everything that StartAction/StopAction changed (Blueprint variables included).
+	UPROPERTY(EditDefaultsOnly, Category = "Action")
+	bool bPooled;
+
+	// Server : copy what clients need into our ActionList entry
+	virtual void GetRepState(FActionListEntry& Entry) const;
+
+	// Clients : take over the state the server sent
+	virtual void ApplyRepState(const FActionListEntry& Entry);
+
+	// Called before a pooled action is handed out again, back to the state of a freshly created action.
+	// Blueprint actions with bPooled override this to reset their own variables (call the parent).
+	UFUNCTION(BlueprintNativeEvent, Category = "Action")
+	void ResetAction();
+
+	// Call TickAction every frame while running. Off by default, the owning component doesn't tick at all unless one of its running actions needs it.
+	UPROPERTY(EditDefaultsOnly, Category = "Action")
+	bool bTickWhileRunning;
+
 	UFUNCTION(BlueprintCallable, Category = "Action")
 	bool IsRunning() const;
 
@@ -108,6 +130,10 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "Action")
 	void StopAction(AActor* Instigator);
 
+	// Only called while running with bTickWhileRunning set
+	UFUNCTION(BlueprintNativeEvent, Category = "Action")
+	void TickAction(float DeltaTime);
+
 	// Action nickname to start/stop without a reference to the object
 	UPROPERTY(EditDefaultsOnly, Category = "Action")
 	FName ActionName; // FName is hashed - Faster than FString for comparing between different ActionNames
@@ -117,8 +143,15 @@ public:
 		// will not show up in blueprint editor window in child classes.
 	UWorld* GetWorld() const override;
 
-	virtual bool IsSupportedForNetworking() const override // implement directly in header since this just returns true
-	{
-		return true;
-	}
+	USAction();
+
+private:
+
+	/* Slot inside the owning component's ActionList (server only), INDEX_NONE while not in it. Managed by the component only. */
+	int32 ActionListIndex;
+
+	/* World time this action went back into its component's pool, see USActionComponent::AcquireAction */
+	float TimeReleased;
+
+	friend class USActionComponent;
 };
@@ -5,9 +5,86 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "GameplayTagContainer.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "SAction.h"
 #include "SActionComponent.generated.h"
 
-class USAction;
+class USActionComponent;
+struct FActionList;
+
+/* Replicated state of a single action. Clients create their own USAction from ActionClass, the objects themselves are not replicated. */
+USTRUCT()
+struct FActionListEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TSubclassOf<USAction> ActionClass;
+
+	UPROPERTY()
+	FActionRepData RepData;
+
+	UPROPERTY()
+	float TimeStarted = 0.0f;
+
+	/* Only used by effects (USActionEffect::StackCount) */
+	UPROPERTY()
+	uint8 StackCount = 0;
+
+	/* Server's action, or the client's local copy of it */
+	UPROPERTY(NotReplicated)
+	USAction* Action = nullptr;
+
+	void PreReplicatedRemove(const FActionList& InArraySerializer);
+
+	void PostReplicatedAdd(const FActionList& InArraySerializer);
+
+	void PostReplicatedChange(const FActionList& InArraySerializer);
+};
+
+/**
+ * Actions of a USActionComponent, replicated as a delta : only entries added, removed or marked dirty since the last update are compared and sent,
+ * instead of the whole Actions array plus every action as a subobject with its own properties.
+ */
+USTRUCT()
+struct FActionList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<FActionListEntry> Items;
+
+	/* Component this list belongs to, never saved or replicated. Set in USActionComponent::PostInitProperties, not the constructor :
+	InitProperties copies ActionList from the archetype (Blueprint or instanced component template), which would leave it pointing at the template. */
+	USActionComponent* OwnerComp = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FActionList> : public TStructOpsTypeTraitsBase2<FActionList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+USTRUCT()
+struct FActionPoolBucket
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Removed actions of a single class, oldest first */
+	UPROPERTY()
+	TArray<USAction*> Actions;
+};
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnActionStateChanged, USActionComponent*, OwningComp, USAction*, Action);
 
@@ -27,7 +104,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Actions")
 	void RemoveAction(USAction* ActionToRemove);
 
-	/* Returns first occurance of action matching the class provided */
+	/* Returns first occurance of action matching the class provided. Actions of exactly that class are found through the index, subclasses need a scan. */
 	UFUNCTION(BlueprintCallable, Category = "Actions")
 	USAction* GetAction(TSubclassOf<USAction> ActionClass) const;
 
@@ -37,6 +114,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Actions")
 	bool StopActionByName(AActor* Instigator, FName ActionName);
 
+	/* Stop and remove every action and tag, then grant DefaultActions again. Used when recycling a pooled actor. */
+	void ResetActions();
+
+	const TArray<USAction*>& GetActions() const { return Actions; }
+
+	/* Server : copies the action's replicated state into its ActionList entry, call after changing it */
+	void MarkActionDirty(USAction* Action);
+
+	/* Called by actions with bTickWhileRunning when they start/stop, the component only ticks while at least one of them runs */
+	void SetActionTicking(USAction* Action, bool bTicking);
+
+	/* Logs live and pooled actions per class of every action component in World, plus pool hits/misses */
+	static void LogPoolStats(UWorld* World);
+
+	/* Logs the cost of StartActionByName/GetAction style lookups through the index vs. a scan of Actions, on a transient component with NumActions actions */
+	static void LogLookupBenchmark(AActor* Owner, int32 NumActions, int32 NumLookups = 100000);
+
 	// Sets default values for this component's properties
 	USActionComponent();
 
@@ -52,14 +146,64 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Actions")
 	TArray<TSubclassOf<USAction>> DefaultActions;
 
-	UPROPERTY(BlueprintReadOnly, Replicated)
+	/* Server : the actions in ActionList. Clients : local copies created from it. */
+	UPROPERTY(BlueprintReadOnly)
 	TArray<USAction*> Actions;
 
+	UPROPERTY(Replicated)
+	FActionList ActionList;
+
+	/* ActionList callbacks on clients */
+	void OnActionEntryAdded(FActionListEntry& Entry);
+
+	void OnActionEntryChanged(FActionListEntry& Entry);
+
+	void OnActionEntryRemoved(FActionListEntry& Entry);
+
+	friend struct FActionListEntry;
+
+	/* Actions per ActionName, in the order they were added. Kept in sync with Actions by AddAction/RemoveAction (server) and the ActionList callbacks (clients). */
+	TMap<FName, TArray<USAction*, TInlineAllocator<1>>> ActionsByName;
+
+	/* Actions per exact class, in the order they were added */
+	TMap<UClass*, TArray<USAction*, TInlineAllocator<1>>> ActionsByClass;
+
+	/* Running actions that want TickAction */
+	TArray<USAction*> TickingActions;
+
+	/* Removed actions with bPooled, reused by AddAction of the same class instead of creating a new object (e.g. burning on every projectile hit, once it opts in).
+	Clients pool the local copies they create for ActionList the same way. */
+	UPROPERTY()
+	TMap<UClass*, FActionPoolBucket> ActionPools;
+
+	/* Per class cap, anything beyond that is left to GC */
+	UPROPERTY(EditDefaultsOnly, Category = "Actions")
+	int32 MaxPooledActionsPerClass;
+
+	int32 NumPoolHits;
+
+	int32 NumPoolMisses;
+
+	/* Pooled action of exactly ActionClass or a new one */
+	USAction* AcquireAction(TSubclassOf<USAction> ActionClass);
+
+	/* Action must already be out of Actions */
+	void ReleaseAction(USAction* Action);
+
+	/* How long a released action stays in the pool before it can be handed out again, one net update of our owner */
+	float GetMinPoolReuseDelay() const;
+
+	void AddToIndex(USAction* Action);
+
+	void RemoveFromIndex(USAction* Action);
+
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	void StopAllActions();
+
 public:	
 
 	UPROPERTY(BlueprintAssignable)
@@ -68,9 +212,13 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnActionStateChanged OnActionStopped;
 
-	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags);
+	/* An effect with StackingPolicy Stack gained a stack (see USActionEffect::GetStackCount), also fires on clients */
+	UPROPERTY(BlueprintAssignable)
+	FOnActionStateChanged OnEffectStacksChanged;
+
+	virtual void PostInitProperties() override;
 
-	// Called every frame
+	// Only while TickingActions is not empty
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 		
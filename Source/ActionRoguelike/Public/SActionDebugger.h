@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+class USActionComponent;
+class UCanvas;
+class APlayerController;
+
+/**
+ * On screen view of every action component's actions and tags, drawn next to their owners (su.ActionDebug 1).
+ * A single UDebugDrawService callback draws all components at once, components only cost anything while the cvar is on.
+ * Replaces the per frame LogOnScreen messages USActionComponent used to push from TickComponent. Not compiled into Shipping.
+ */
+struct ACTIONROGUELIKE_API FActionDebugger
+{
+public:
+
+	/* Called by USActionComponent in BeginPlay/EndPlay */
+	static void AddComponent(USActionComponent* ActionComp);
+
+	static void RemoveComponent(USActionComponent* ActionComp);
+
+private:
+
+	static void Draw(UCanvas* Canvas, APlayerController* PC);
+
+	static TArray<TWeakObjectPtr<USActionComponent>> Components;
+
+	static FDelegateHandle DrawHandle;
+};
+
+#endif
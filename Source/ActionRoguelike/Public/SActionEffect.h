@@ -6,6 +6,20 @@
 #include "SAction.h"
 #include "SActionEffect.generated.h"
 
+/* What happens when an effect is applied to an actor that already has it running */
+UENUM(BlueprintType)
+enum class EEffectStackingPolicy : uint8
+{
+	/* Every application runs as its own instance with its own duration (default, how effects always behaved) */
+	Independent,
+	/* Restart the duration of the running effect */
+	Refresh,
+	/* Add a stack (up to MaxStacks) and restart the duration, periodic ticks run once per stack */
+	Stack,
+	/* Keep the running effect as it is */
+	Ignore
+};
+
 /**
  * 
  */
@@ -21,6 +35,17 @@ public:
 	void StartAction_Implementation(AActor* Instigator) override;
 	void StopAction_Implementation(AActor* Instigator) override;
 
+	void ResetAction_Implementation() override;
+
+	virtual void GetRepState(FActionListEntry& Entry) const override;
+
+	virtual void ApplyRepState(const FActionListEntry& Entry) override;
+
+	/* Server : merge another application of this effect into the running one according to StackingPolicy (see USActionComponent::AddAction) */
+	void Reapply(AActor* Instigator);
+
+	EEffectStackingPolicy GetStackingPolicy() const { return StackingPolicy; }
+
 
 protected:
 
@@ -31,9 +56,16 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effect")
 	float Period;
 
-	// timer handles exposed in header as they need to be cancelled at some point
-	FTimerHandle PeriodHandle;
-	FTimerHandle DurationHandle;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effect")
+	EEffectStackingPolicy StackingPolicy;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Effect", meta = (ClampMin = 1, ClampMax = 255, EditCondition = "StackingPolicy == EEffectStackingPolicy::Stack"))
+	int32 MaxStacks;
+
+	/* Applications merged into this instance, a single byte on the wire (FActionListEntry::StackCount) */
+	UPROPERTY()
+	uint8 StackCount;
+
 
 	UFUNCTION(BlueprintNativeEvent, Category = "Effect")
 	void ExecutePeriodicEffect(AActor* InstigatorActor);
@@ -43,5 +75,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Action")
 	float GetTimeRemaining() const;
 
+	UFUNCTION(BlueprintCallable, Category = "Action")
+	int32 GetStackCount() const;
+
 	USActionEffect();
+
+private:
+
+	/* Slot inside USEffectSchedulerSubsystem's arrays, INDEX_NONE while not scheduled. Managed by the scheduler only. */
+	int32 SchedulerIndex;
+
+	/* Called by the scheduler every Period, runs ExecutePeriodicEffect once per stack */
+	void ExecutePeriodicTick();
+
+	friend class USEffectSchedulerSubsystem;
 };
@@ -55,6 +55,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Attributes")
 	bool Kill(AActor* InstigatorActor);
 
+	/* Back to full health and no rage, used when recycling a pooled actor. Server only. */
+	void ResetAttributes();
+
 	UFUNCTION(BlueprintCallable, Category = "Attributes")
 	bool IsAlive() const;
 
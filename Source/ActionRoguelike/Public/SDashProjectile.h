@@ -30,6 +30,9 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	// Reused from the pool, BeginPlay won't run again
+	virtual void Launch() override;
+
 public:
 
 	ASDashProjectile();
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SEffectSchedulerSubsystem.generated.h"
+
+class USActionEffect;
+
+/**
+ * Runs the duration and period of every running USActionEffect in the world, instead of two FTimerManager timers per effect bound by function name.
+ * Deadlines live in parallel arrays (one entry per effect) and are processed in a single pass after the actors ticked,
+ * frames where nothing is due only compare the time against the earliest deadline.
+ * Periodic ticks are executed for every period that elapsed by the end of the effect, including one landing exactly on it, before the effect is stopped.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USEffectSchedulerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Scheduled effects, the arrays below are indexed the same way (USActionEffect::SchedulerIndex) */
+	UPROPERTY()
+	TArray<USActionEffect*> Effects;
+
+	/* World time the effect stops, MAX_flt for effects without a duration */
+	TArray<float> EndTimes;
+
+	/* World time of the next periodic tick, MAX_flt for effects without a period. Always StartTimes + (NumTicks + 1) * Periods,
+	never accumulated, so rounding errors don't add up over long effects. */
+	TArray<float> NextPeriodTimes;
+
+	TArray<float> Periods;
+
+	/* World time the effect was added, the period counts from here */
+	TArray<float> StartTimes;
+
+	/* Periodic ticks executed so far */
+	TArray<int32> NumTicks;
+
+	/* Earliest entry in EndTimes/NextPeriodTimes (may be early after removals, never late) */
+	float NextDueTime;
+
+	/* Scratch list for ProcessDueEffects, effects may add/remove others while we call into them */
+	TArray<USActionEffect*> DueEffects;
+
+	FDelegateHandle PostActorTickHandle;
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void ProcessDueEffects(float Now);
+
+	void UpdateNextDueTime();
+
+	bool IsScheduled(const USActionEffect* Effect) const;
+
+public:
+
+	/* Starts Duration and Period (<= 0 means none) from the current world time */
+	void AddEffect(USActionEffect* Effect, float Duration, float Period);
+
+	/* Restart the duration from the current world time, the period keeps its rhythm */
+	void RefreshDuration(USActionEffect* Effect, float Duration);
+
+	void RemoveEffect(USActionEffect* Effect);
+
+	int32 GetNumEffects() const { return Effects.Num(); }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};
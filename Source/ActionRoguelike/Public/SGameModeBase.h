@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "EnvironmentQuery/EnvQueryTypes.h" // necessary since we could not forward declare the enum needed in OnQueryCompleted -> EEnvQueryStatus::Type
 #include "Engine/DataTable.h"
+#include "SMonsterCatalog.h"
+#include "Async/Future.h"
 #include "SGameModeBase.generated.h"
 
 class UEnvQuery;
@@ -14,6 +16,44 @@ class UCurveFloat;
 class USSaveGame;
 class UDataTable;
 class USMonsterData;
+class ASPlayerState;
+struct FSaveGameWriteResult;
+struct FSaveGameLoadState;
+struct FActorSaveData;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSaveGameWritten, const FString&, SlotName, bool, bSuccess);
+
+/* Timings and sizes of one save benchmark run, see ASGameModeBase::RunSaveBenchmark */
+struct FSaveBenchmarkResult
+{
+	int32 NumActors = 0;
+
+	/* Actors in the save, every registered one (not only the benchmark's) */
+	int32 NumSaved = 0;
+
+	/* Benchmark actors the loaded save was applied to */
+	int32 NumRestored = 0;
+
+	bool bLoaded = false;
+
+	double SerializeMs = 0.0;
+	double SnapshotMs = 0.0;
+	double PackMs = 0.0;
+	double CompressMs = 0.0;
+	double WriteMs = 0.0;
+	double LoadMs = 0.0;
+	double IndexMs = 0.0;
+	double RestoreMs = 0.0;
+
+	int32 BytesWritten = 0;
+	int32 UncompressedBytes = 0;
+
+	double PeakMemoryDeltaMB = 0.0;
+
+	static const TCHAR* CsvHeader;
+
+	FString ToCsvRow() const;
+};
 
 /* DataTable Row for spawning monsters in game mode  */
 USTRUCT(BlueprintType) // BlueprintType as we want this struct/DataTable Row to be accesible to Blueprints.
@@ -50,6 +90,14 @@ public:
 
 };
 
+/* Monster of a wave that got its spawn location and is waiting for its turn to spawn */
+struct FPendingBotSpawn
+{
+	FPrimaryAssetId MonsterId;
+
+	FVector Location;
+};
+
 /**
  * 
  */
@@ -65,6 +113,108 @@ protected:
 	UPROPERTY()
 	USSaveGame* CurrentSaveGame;
 
+	/* A write started by WriteSaveGame is still running on a worker thread */
+	bool bSaveInFlight;
+
+	/* WriteSaveGame was called while a write was in flight. Requests are coalesced into a single follow-up save once it finishes, only the latest state matters. */
+	bool bSaveQueued;
+
+	TFuture<void> PendingSaveWrite;
+
+	void OnSaveGameWriteFinished(const FSaveGameWriteResult& Result);
+
+	/* Gameplay actors whose saved state changed since the last WriteSaveGame */
+	TSet<TWeakObjectPtr<AActor>> DirtySaveActors;
+
+	/* Next WriteSaveGame re-serializes every gameplay actor instead of only the dirty ones. Set for the first save of a session
+	so the save file matches the current level (actors added to or removed from the map since it was written). */
+	bool bFullSaveRequired;
+
+	/* Registered later on (spawned powerups, streamed in chests) : never saved yet, so dirty */
+	void OnSaveActorRegistered(AActor* Actor);
+
+	/* Destroyed actors leave the save, otherwise their entry would be applied again on every load. Streamed out actors keep it. */
+	void OnSaveActorUnregistered(AActor* Actor);
+
+	FDelegateHandle SaveActorRegisteredHandle;
+
+	FDelegateHandle SaveActorUnregisteredHandle;
+
+	/* Seconds between autosaves, 0 disables the timer (autosaves on wave cleared and chest opened still happen) */
+	UPROPERTY(EditDefaultsOnly, Category = "SaveGame")
+	float AutosaveInterval;
+
+	/* Autosaves serialize actors across frames, spending at most this long per frame */
+	UPROPERTY(EditDefaultsOnly, Category = "SaveGame")
+	float AutosaveFrameBudgetMs;
+
+	FTimerHandle TimerHandle_Autosave;
+
+	FTimerHandle TimerHandle_ProcessAutosave;
+
+	/* Actors left to serialize for the save in progress */
+	TArray<TWeakObjectPtr<AActor>> SaveQueue;
+
+	/* Between BeginActorSave and FinishActorSave, actors are being serialized */
+	bool bActorSaveInProgress;
+
+	int32 NumActorsSerialized;
+
+	int32 NumSaveFrames;
+
+	/* Queues all registered actors (full save) or only the dirty ones */
+	void BeginActorSave();
+
+	/* Returns true once SaveQueue is empty. BudgetMs <= 0 serializes everything left. */
+	bool SerializeSaveQueue(float BudgetMs);
+
+	/* Catches up on actors changed during the save, adds the player state and starts the write */
+	void FinishActorSave();
+
+	void ProcessAutosave();
+
+	/* Updates the record of every player in CurrentSaveGame */
+	void SavePlayerRecords();
+
+	/* Copies CurrentSaveGame and hands it to a worker thread */
+	void StartSaveWrite();
+
+	/* A save was loaded in InitGame, apply it to the registered actors in StartPlay */
+	bool bRestoreSavedActors;
+
+	/* The slot is still being read on a worker thread (started in InitGame). Saves wait for it, or they would overwrite the file with an empty save. */
+	bool bSaveGameLoading;
+
+	/* The player records are not in CurrentSaveGame yet. They are read before the (much larger) actor data. */
+	bool bSavePlayersLoading;
+
+	TFuture<void> PendingSaveLoad;
+
+	/* Set first thing in EndPlay. Callbacks the save workers queued on the game thread can still arrive afterwards (we stay valid until GC), they check this and do nothing. */
+	bool bHasEndedPlay;
+
+	/* Joined while bSavePlayersLoading, their records are applied as soon as those are read */
+	TArray<TWeakObjectPtr<ASPlayerState>> PlayersAwaitingSaveGame;
+
+	void OnSavePlayersLoaded(FSaveGameLoadState& LoadState);
+
+	void OnSaveActorsLoaded(FSaveGameLoadState& LoadState);
+
+	void FinishSaveGameLoad();
+
+	void RestoreSavedActors();
+
+	/* Applies SaveGame to all registered actors it has data for, returns how many */
+	int32 RestoreActors(USSaveGame* SaveGame);
+
+	/* Applies the data SaveGame has for Actor (if any), returns false if there was none */
+	static bool RestoreActor(USSaveGame* SaveGame, AActor* Actor);
+
+	void RunSaveBenchmarks(const TArray<int32>& NumActorsPerRun);
+
+	/* Converts Actor's SaveGame UPROPERTIES and transform into ActorData */
+	static void SerializeActorForSave(AActor* Actor, FActorSaveData& ActorData);
+
 	/* All available monsters */
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	UDataTable* MonsterTable;
@@ -72,9 +222,41 @@ protected:
 	//UPROPERTY(EditDefaultsOnly, Category = "AI")
 	//TSubclassOf<AActor> MinionClass;
 
+	/* MonsterTable compiled for weighted picks. Built (and its monsters preloaded) in InitGame, rebuilt when the DataTable is edited. */
+	FMonsterCatalog MonsterCatalog;
+
+	/* Match seed for all USRandomSubsystem channels, 0 = new random seed every match.
+	 * Can be overridden with ?Seed=123 or su.RandomSeed to replay the same spawn and combat sequences. */
+	UPROPERTY(EditDefaultsOnly, Category = "Random")
+	int32 RandomSeed;
+
+#if WITH_EDITOR
+	FDelegateHandle MonsterTableChangedHandle;
+#endif
+
+	void RebuildMonsterCatalog();
+
+	/* Bundles of monster data that are always preloaded (e.g. gameplay/server data) */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	TArray<FName> MonsterPreloadBundles;
+
+	/* Additional bundles only preloaded when we can actually display them (skipped on dedicated servers) */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	TArray<FName> MonsterPreloadCosmeticBundles;
+
+	/* Warm up USMonsterAssetCache with every monster referenced by MonsterTable */
+	void PreloadMonsterAssets();
+
+	void OnMonsterPreloaded(USMonsterData* MonsterData);
+
+	/* Run once and cached by USSpawnLocationCache, not for every wave */
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	UEnvQuery* SpawnBotQuery;
 
+	/* Re-run SpawnBotQuery in the background once a player moved further than this from where it last ran */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float SpawnLocationRefreshDistance;
+
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	UCurveFloat* DifficultyCurve;
 
@@ -83,6 +265,36 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	float SpawnTimerInterval;
 
+	/* Spawn points gained per second, sampled at current match time. Optional, falls back to SpawnPointsPerSecond. */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	UCurveFloat* SpawnPointsCurve;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float SpawnPointsPerSecond;
+
+	/* Cap for saved up spawn points, avoids a huge burst after a long time at maximum bot capacity. Should be >= the highest SpawnCost. */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float MaxSpawnPoints;
+
+	/* Max amount of monsters bought in a single wave (sharing one EQS query) */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	int32 MaxWaveSize;
+
+	/* Wave spawns are spread across frames, this many per frame */
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	int32 MaxBotSpawnsPerFrame;
+
+	float AvailableSpawnPoints;
+
+	TArray<FPendingBotSpawn> BotSpawnQueue;
+
+	/* Spawns waiting on the AssetManager to load their monster data */
+	int32 NrOfBotsLoading;
+
+	FTimerHandle TimerHandle_ProcessBotSpawnQueue;
+
+	void ProcessBotSpawnQueue();
+
 	// Read/write access as we could change this as our difficulty increases via Blueprint
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "AI")
 	int32 CreditsPerKill;
@@ -102,13 +314,23 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Powerups")
 	int32 DesiredPowerupCount;
 
-	void SpawnBotTimerElapsed();
+	/* Placed powerups are spawned across frames, this many per frame. Keeps large maps with thousands of pickups from stalling on match start. */
+	UPROPERTY(EditDefaultsOnly, Category = "Powerups")
+	int32 MaxPowerupSpawnsPerFrame;
 
-	UFUNCTION()
-	void OnBotSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrapper* QueryInstance, EEnvQueryStatus::Type QueryStatus);
+	/* Locations picked by FPlacementGrid still waiting for their powerup */
+	TArray<FVector> PowerupSpawnQueue;
+
+	FTimerHandle TimerHandle_ProcessPowerupSpawnQueue;
+
+	void ProcessPowerupSpawnQueue();
+
+	void SpawnBotTimerElapsed();
 
 	void OnMonsterLoaded(FPrimaryAssetId LoadedId, FVector SpawnLocation);
 
+	void SpawnMonster(USMonsterData* MonsterData, FVector SpawnLocation);
+
 	UFUNCTION()
 	void OnPowerupSpawnQueryCompleted(UEnvQueryInstanceBlueprintWrapper* QueryInstance, EEnvQueryStatus::Type QueryStatus);
 
@@ -125,6 +347,8 @@ public:
 
 	virtual void StartPlay() override; // calls BeginPlay on actors.
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Since this is marked as BlueprintNativeEvent in base class AGameModeBase we have to override the implementation part of the function.
 	// Note that HandleStartingNewPlayer is also declared as Non-Virtual in base class AGameModeBase!
 	// However UnrealHeaderTool will generate the _Implementation part as virtual, hence us repeating the word virtual in our declaration for clarity.
@@ -136,12 +360,72 @@ public:
 	// (e.g. if Derived obj overriden function is called from Base obj ptr, the Base obj original (non-virtual!) function will get called instead!
 	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
 
+	virtual void Logout(AController* Exiting) override;
+
 	UFUNCTION(Exec)
 	void KillAll();
 
+	/* Print hits/misses, load times and resident memory of the monster asset cache */
+	UFUNCTION(Exec)
+	void MonsterCacheStats();
+
+	/* Print pooled bots per class and pool hits/misses */
+	UFUNCTION(Exec)
+	void BotPoolStats();
+
+	/* Print pooled projectiles per class and pool hits/misses */
+	UFUNCTION(Exec)
+	void ProjectilePoolStats();
+
+	/* Print live and pooled actions per class and action pool hits/misses */
+	UFUNCTION(Exec)
+	void ActionPoolStats();
+
+	/* Print available spawn locations and how many EQS queries were needed so far */
+	UFUNCTION(Exec)
+	void SpawnLocationCacheStats();
+
+	/* Print registered savable actors and save priority per class */
+	UFUNCTION(Exec)
+	void SaveRegistryStats();
+
+	/* Time save, load and restore with NumActors synthetic savable actors spawned in, results are logged and written to Saved/Profiling/SaveBenchmark.
+	Convenience for a running match, the ActionRoguelike.SaveGame.Benchmark automation test (1k/10k/50k) is what gates changes. */
+	UFUNCTION(Exec)
+	void SaveBenchmark(int32 NumActors);
+
+	/* One SaveBenchmark run in World, spawns and destroys its own actors. Also used by the ActionRoguelike.SaveGame.Benchmark automation test. */
+	static void RunSaveBenchmark(UWorld* World, int32 NumActors, FSaveBenchmarkResult& OutResult);
+
+	/* Compare finding actions by name and class through USActionComponent's index vs. scanning its Actions, with NumActions actions */
+	UFUNCTION(Exec)
+	void ActionLookupBenchmark(int32 NumActions);
+
+	/* Compare size and read/write speed of the current save data in our save file format vs. the default SaveGameToSlot one */
+	UFUNCTION(Exec)
+	void SaveGameFormatStats();
+
+	/* Snapshots all saved state on the game thread, then serializes, compresses and writes it on a worker thread. See OnSaveGameWritten. */
 	UFUNCTION(BlueprintCallable, Category = "SaveGame")
 	void WriteSaveGame();
 
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	bool IsSaveGameInFlight() const;
+
+	/* Saves without a frame spike, actors are serialized across frames within AutosaveFrameBudgetMs. Does nothing while one is already running.
+	Called every AutosaveInterval, when a wave is cleared and when a chest is opened. */
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	void RequestAutosave();
+
+	/* Call whenever a gameplay actor changes any of its 'SaveGame' state, only dirty actors are re-serialized by the next WriteSaveGame */
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	void MarkActorSaveDirty(AActor* Actor);
+
+	/* Fires on the game thread once the file write started by WriteSaveGame is done (or failed) */
+	UPROPERTY(BlueprintAssignable, Category = "SaveGame")
+	FOnSaveGameWritten OnSaveGameWritten;
+
+	/* Starts reading the save slot on a worker thread, CurrentSaveGame is filled in on the game thread once its parts are read */
 	void LoadSaveGame();
 
 };
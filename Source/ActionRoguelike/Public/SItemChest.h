@@ -5,12 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "SGameplayInterface.h"
+#include "SSaveGameInterface.h"
 #include "SItemChest.generated.h"
 
 class UStaticMeshComponent;
 
 UCLASS()
-class ACTIONROGUELIKE_API ASItemChest : public AActor, public ISGameplayInterface
+class ACTIONROGUELIKE_API ASItemChest : public AActor, public ISGameplayInterface, public ISSaveGameInterface
 {
 	GENERATED_BODY()
 
@@ -22,6 +23,9 @@ public:
 	void Interact_Implementation(APawn* InstigatorPawn);
 
 	void OnActorLoaded_Implementation();
+
+	/* Opened chests are player progress, restore those before anything else */
+	int32 GetSavePriority_Implementation() const override;
 	
 public:	
 	// Sets default values for this actor's properties
@@ -44,6 +48,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
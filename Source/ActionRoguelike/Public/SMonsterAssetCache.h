@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "SMonsterAssetCache.generated.h"
+
+class USMonsterData;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMonsterReady, USMonsterData*);
+
+/**
+ * Keeps every "Monsters" primary asset used by the match loaded and resident,
+ * so GameMode can spawn synchronously instead of waiting on UAssetManager::LoadPrimaryAsset for each bot.
+ * Preloading is kicked off by GameMode in InitGame, see ASGameModeBase::PreloadMonsterAssets.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USMonsterAssetCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Fully loaded monsters, ready to spawn from */
+	UPROPERTY()
+	TMap<FPrimaryAssetId, USMonsterData*> LoadedMonsters;
+
+	/* Handles keep the assets (and their bundles) resident for the whole match */
+	TMap<FPrimaryAssetId, TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+	int32 NumCacheHits;
+
+	int32 NumCacheMisses;
+
+	/* Sum of time between requesting and finishing each preload */
+	double TotalLoadTimeMs;
+
+	int64 ResidentBytes;
+
+	void OnMonsterPreloaded(FPrimaryAssetId MonsterId, double RequestTime);
+
+public:
+
+	/* Start loading all monsters not already cached. Safe to call again, e.g. after the MonsterTable was edited. */
+	void PreloadMonsters(const TArray<FPrimaryAssetId>& MonsterIds, const TArray<FName>& Bundles);
+
+	/* Returns the monster if it is warm in the cache (counts as hit), nullptr otherwise (counts as miss) */
+	USMonsterData* FindLoadedMonster(const FPrimaryAssetId& MonsterId);
+
+	bool IsPreloadComplete() const;
+
+	/* Fires once per monster when it finished preloading */
+	FOnMonsterReady OnMonsterReady;
+
+	void LogStats() const;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDataTable;
+struct FMonsterInfoRow;
+
+/**
+ * Compiled, read-only view of the MonsterTable used by GameMode to pick which monster to spawn.
+ * Built once (and again whenever the DataTable changes in editor) so picking never has to call GetAllRows or allocate.
+ * Picks honor FMonsterInfoRow::Weight using Vose's alias method : O(n) to build, O(1) per pick.
+ */
+struct ACTIONROGUELIKE_API FMonsterCatalog
+{
+public:
+
+	/* (Re)compile the catalog from the table. Rows with no MonsterId or a Weight <= 0 are skipped. */
+	void Build(const UDataTable* MonsterTable);
+
+	void Reset();
+
+	/* Weighted random row, nullptr if catalog is empty. Rows point into the DataTable so they stay valid until the next Build. */
+	const FMonsterInfoRow* PickRandomRow(const FRandomStream& RandomStream) const;
+
+	bool IsEmpty() const { return Rows.Num() == 0; }
+
+	const TArray<const FMonsterInfoRow*>& GetRows() const { return Rows; }
+
+private:
+
+	TArray<const FMonsterInfoRow*> Rows;
+
+	/* Alias method tables, same size as Rows. Probability[i] is the chance to keep column i, otherwise Alias[i] is picked. */
+	TArray<float> Probability;
+	TArray<int32> Alias;
+};
@@ -25,6 +25,10 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spawn Info")
 	TArray<TSubclassOf<USAction>> Actions;
 
+	/* Amount of bots of MonsterClass spawned (deactivated) into the bot pool at match start, so the first waves can reuse them */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spawn Info")
+	int32 PoolWarmUpCount;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI")
 	UTexture2D* Icon;
 
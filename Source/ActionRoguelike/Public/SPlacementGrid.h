@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid to keep placed points at least MinDistance apart (Poisson-disk style rejection).
+ * Cells are MinDistance wide, so any point too close to a new one must sit in one of the 27 surrounding cells :
+ * rejecting a candidate is O(1) no matter how many points were already placed.
+ * Used by GameMode to scatter powerups over the EQS results, but works for any kind of placement.
+ */
+struct ACTIONROGUELIKE_API FPlacementGrid
+{
+public:
+
+	explicit FPlacementGrid(float InMinDistance = 0.0f);
+
+	/* Forget all points and optionally switch to a new distance */
+	void Reset(float InMinDistance);
+
+	/* True if no placed point is closer than MinDistance */
+	bool IsFarEnough(const FVector& Location) const;
+
+	/* Place the point without any check */
+	void Add(const FVector& Location);
+
+	/* Place the point only if it passes IsFarEnough */
+	bool TryAdd(const FVector& Location);
+
+	int32 Num() const { return Points.Num(); }
+
+	const TArray<FVector>& GetPoints() const { return Points; }
+
+	/**
+	 * Randomly pick up to MaxCount candidates that are all at least MinDistance apart.
+	 * Candidates are consumed (swap-removed as they are drawn, so order is not preserved) which keeps every draw O(1).
+	 * Returns the number of locations added to OutLocations.
+	 */
+	static int32 SelectLocations(TArray<FVector>& Candidates, float MinDistance, int32 MaxCount, const FRandomStream& RandomStream, TArray<FVector>& OutLocations);
+
+private:
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	float MinDistance;
+
+	float InvCellSize;
+
+	TArray<FVector> Points;
+
+	/* Points are chained per cell : CellHeads holds the last point added to a cell, NextInCell links to the previous one (INDEX_NONE ends the chain) */
+	TMap<FIntVector, int32> CellHeads;
+	TArray<int32> NextInCell;
+};
@@ -10,6 +10,7 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnCreditsChanged, ASPlayerState*, PlayerState, int32, NewCredits, int32, Delta);
 
 class USSaveGame;
+struct FPlayerSaveData;
 
 /**
  *
@@ -46,9 +47,16 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Events")
 	FOnCreditsChanged OnCreditsChanged;
 
+	/* Key of this player's record in the save, the unique net id (stable between sessions with an online subsystem) or the player name without one */
+	FString GetSaveId() const;
+
+	/* Game thread : fills in this player's record in SaveObject. Override in Blueprint to save extra data. */
 	UFUNCTION(BlueprintNativeEvent)
 	void SavePlayerState(USSaveGame* SaveObject);
 
+	/* Writes our 'SaveGame' properties into Record. Game thread, like any other UObject Serialize(). */
+	void SerializeSaveData(FPlayerSaveData& Record);
+
 	UFUNCTION(BlueprintNativeEvent)
 	void LoadPlayerState(USSaveGame* SaveObject);
 };
\ No newline at end of file
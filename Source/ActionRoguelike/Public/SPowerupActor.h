@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "SGameplayInterface.h"
+#include "SSaveGameInterface.h"
 #include "SPowerupActor.generated.h"
 
 
@@ -12,7 +13,7 @@ class USphereComponent;
 class UStaticMeshComponent;
 
 UCLASS(ABSTRACT)
-class ACTIONROGUELIKE_API ASPowerupActor : public AActor, public ISGameplayInterface
+class ACTIONROGUELIKE_API ASPowerupActor : public AActor, public ISGameplayInterface, public ISSaveGameInterface
 {
 	GENERATED_BODY()
 
@@ -42,6 +43,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	UStaticMeshComponent* MeshComp;
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 
 	void Interact_Implementation(APawn* InstigatorPawn) override;
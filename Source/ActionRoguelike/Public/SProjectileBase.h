@@ -14,6 +14,28 @@ class UAudioComponent;
 class USoundCue;
 class UCameraShake;
 
+USTRUCT()
+struct FProjectileLaunchInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	FProjectileLaunchInfo()
+		: Location(ForceInitToZero), Rotation(ForceInitToZero), ReuseCount(0)
+	{}
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FRotator Rotation;
+
+	/* Bumped on every reuse, so the OnRep also fires when fired twice from the exact same spot */
+	UPROPERTY()
+	uint8 ReuseCount;
+};
+
 UCLASS(ABSTRACT) // 'ABSTRACT' marks this class as incomplete, keeping this out of certain dropdowns windows like SpawnActor in Unreal Editor
 class ACTIONROGUELIKE_API ASProjectileBase : public AActor
 {
@@ -61,4 +83,32 @@ protected:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent)
 	void Explode();
 
+	/* Movement is not replicated, clients simulate the flight themselves from where (and how) the server fired it */
+	UPROPERTY(ReplicatedUsing = "OnRep_LaunchInfo")
+	FProjectileLaunchInfo LaunchInfo;
+
+	UFUNCTION()
+	void OnRep_LaunchInfo();
+
+	/* Sitting in USProjectilePoolSubsystem (or on clients : finished flying, waiting for the server to reuse it) */
+	bool bIsPooled;
+
+	/* Hand the projectile back to the pool, replaces Destroy(). Clients only stop their local copy. */
+	void ReturnToPool();
+
+	/* (Re)start flight from the current transform. Called on both server and clients when the projectile is reused */
+	virtual void Launch();
+
+	/* Runs out of InitialLifeSpan without hitting anything, return to the pool instead of being destroyed */
+	virtual void LifeSpanExpired() override;
+
+public:
+
+	/* Called by USProjectilePoolSubsystem */
+	virtual void DeactivateForPool();
+
+	virtual void ActivateFromPool(const FTransform& SpawnTM, APawn* NewInstigator);
+
+	bool IsPooled() const;
+
 };
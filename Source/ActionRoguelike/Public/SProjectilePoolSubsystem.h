@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SProjectilePoolSubsystem.generated.h"
+
+class ASProjectileBase;
+
+USTRUCT()
+struct FProjectilePoolBucket
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Deactivated projectiles of a single class, waiting to be fired again */
+	UPROPERTY()
+	TArray<ASProjectileBase*> Projectiles;
+};
+
+/**
+ * Recycles projectiles instead of spawning (and destroying) a full actor with sphere, particle, audio and movement components for every shot.
+ * Projectiles hand themselves back on impact or when their lifespan runs out (see ASProjectileBase::ReturnToPool).
+ * Server only, clients relaunch their copy through ASProjectileBase::OnRep_LaunchInfo.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Keyed by projectile class, an exact match is required to reuse a projectile */
+	UPROPERTY()
+	TMap<UClass*, FProjectilePoolBucket> Pools;
+
+	int32 NumPoolHits;
+
+	int32 NumPoolMisses;
+
+public:
+
+	/* Fire a pooled projectile of exactly ProjectileClass, spawns a new one on a pool miss (or for classes not derived from ASProjectileBase) */
+	AActor* AcquireProjectile(UClass* ProjectileClass, const FTransform& SpawnTM, APawn* InstigatorPawn);
+
+	/* Deactivate and store the projectile for later reuse */
+	void ReleaseProjectile(ASProjectileBase* Projectile);
+
+	int32 GetNumPooledProjectiles(UClass* ProjectileClass) const;
+
+	void LogStats() const;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRandomSubsystem.generated.h"
+
+/**
+ * Per world random numbers. Gameplay draws from named FRandomStream channels instead of the global FMath::Rand* functions,
+ * so a match started with the same seed replays the same spawn and combat sequences (e.g. to compare benchmark runs between builds).
+ * Every channel is seeded from the match seed and its own name : systems don't shift each other's sequence by drawing more or less often.
+ * GameMode picks the match seed in InitGame (?Seed=123 URL option, su.RandomSeed cvar or ASGameModeBase::RandomSeed).
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	int32 MatchSeed;
+
+	TMap<FName, FRandomStream> Streams;
+
+	int32 MakeChannelSeed(FName Channel) const;
+
+public:
+
+	/* Monster picks and their spawn locations */
+	static const FName MonsterSpawnChannel;
+
+	/* Powerup placement and type */
+	static const FName PowerupsChannel;
+
+	/* Bullet spread and other combat rolls */
+	static const FName CombatChannel;
+
+	/* Reseeds every channel, including the ones handed out before */
+	void SetMatchSeed(int32 NewSeed);
+
+	int32 GetMatchSeed() const { return MatchSeed; }
+
+	/* Channel is created (and seeded) on first use. Don't hold on to the reference, adding channels may move it. */
+	FRandomStream& GetStream(FName Channel);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SGameplayInterface.h"
+#include "SSaveGameInterface.h"
+#include "SSaveBenchmarkActor.generated.h"
+
+/**
+ * Synthetic savable actor spawned in bulk by the SaveBenchmark command (see ASGameModeBase::SaveBenchmark).
+ * Carries a typical mix of 'SaveGame' properties, no meshes or collision so spawning 50k of them stays cheap.
+ */
+UCLASS(NotPlaceable)
+class ACTIONROGUELIKE_API ASSaveBenchmarkActor : public AActor, public ISGameplayInterface, public ISSaveGameInterface
+{
+	GENERATED_BODY()
+
+protected:
+
+	UPROPERTY(SaveGame)
+	int32 Counter;
+
+	UPROPERTY(SaveGame)
+	float Value;
+
+	UPROPERTY(SaveGame)
+	bool bFlag;
+
+	UPROPERTY(SaveGame)
+	FName Tag;
+
+	UPROPERTY(SaveGame)
+	FVector Offset;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> History;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
+	/* Set by OnActorLoaded from the restored properties, so the restore does some work per actor like real gameplay actors would */
+	int32 LoadedChecksum;
+
+	/* Fill the 'SaveGame' properties with values from Stream */
+	void Randomize(FRandomStream& Stream);
+
+	void OnActorLoaded_Implementation();
+
+	ASSaveBenchmarkActor();
+};
@@ -13,9 +13,9 @@ struct FActorSaveData
 
 public:
 
-	/* Identifier for which Actor this belongs to */
+	/* Identifier for which Actor this belongs to. Level placed actors keep the same name between sessions. */
 	UPROPERTY()
-	FString ActorName; // TODO : since we will be performing string comparison, FNames are better for that than FString
+	FName ActorName;
 
 	/* For movable Actors, keep location,rotation,scale. */
 	UPROPERTY()
@@ -26,6 +26,25 @@ public:
 	TArray<uint8> ByteData;
 };
 
+USTRUCT()
+struct FPlayerSaveData
+{
+	GENERATED_BODY()
+
+public:
+
+	/* Unique net id of the player (see ASPlayerState::GetSaveId) */
+	UPROPERTY()
+	FString PlayerId;
+
+	UPROPERTY()
+	int32 Credits = 0;
+
+	/* Contains all 'SaveGame' marked variables of the PlayerState */
+	UPROPERTY()
+	TArray<uint8> ByteData;
+};
+
 /**
  * 
  */
@@ -36,10 +55,38 @@ class ACTIONROGUELIKE_API USSaveGame : public USaveGame
 	
 public:
 
+	/* Only set by single player saves from before SavedPlayers existed, claimed by the first player to join */
 	UPROPERTY()
 	int32 Credits;
 
+	/* One record per player that was ever part of this save */
+	UPROPERTY()
+	TArray<FPlayerSaveData> SavedPlayers;
+
 	UPROPERTY()
 	TArray<FActorSaveData> SavedActors;
 
+	/* Call once SavedActors is filled in (after loading), FindActorData depends on it */
+	void BuildActorIndex();
+
+	/* Points into SavedActors, invalidated when it changes. nullptr if the actor was never saved. */
+	const FActorSaveData* FindActorData(FName ActorName) const;
+
+	/* For patching single actors into an existing save, keeps the index up to date */
+	FActorSaveData& FindOrAddActorData(FName ActorName);
+
+	/* Drops the actor's entry (e.g. it was destroyed), keeps the index up to date. Order of SavedActors changes. */
+	bool RemoveActorData(FName ActorName);
+
+	/* Linear search, there are only ever a handful of players. nullptr if the player was never saved. */
+	const FPlayerSaveData* FindPlayerData(const FString& PlayerId) const;
+
+	/* Points into SavedPlayers, invalidated when a player is added */
+	FPlayerSaveData& FindOrAddPlayerData(const FString& PlayerId);
+
+protected:
+
+	/* ActorName -> index in SavedActors, not saved itself */
+	TMap<FName, int32> ActorIndex;
+
 };
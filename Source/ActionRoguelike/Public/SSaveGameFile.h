@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SSaveGame.h"
+
+/* Plain copy of the USSaveGame data, owned by the save worker so the game thread can keep changing CurrentSaveGame meanwhile */
+struct FSaveGameSnapshot
+{
+	int32 Credits = 0;
+
+	TArray<FPlayerSaveData> SavedPlayers;
+
+	TArray<FActorSaveData> SavedActors;
+};
+
+/* Outcome and per phase timings of writing a snapshot, filled in on the worker thread */
+struct FSaveGameWriteResult
+{
+	bool bSuccess = false;
+
+	double SerializeMs = 0.0;
+
+	double CompressMs = 0.0;
+
+	double WriteMs = 0.0;
+
+	int32 UncompressedBytes = 0;
+
+	int32 CompressedBytes = 0;
+};
+
+/* Parts of a save file that can be loaded on their own, sections not asked for are skipped without decompressing them */
+enum class ESaveGameSections : uint8
+{
+	None = 0,
+	Player = 1 << 0,
+	Actors = 1 << 1,
+	All = Player | Actors
+};
+ENUM_CLASS_FLAGS(ESaveGameSections);
+
+/**
+ * Our own save file layout :
+ * header (magic, version, section table with offset, sizes and compression of every section) followed by the section data.
+ * Player data and world actors live in separate sections, actors are split into chunks of ActorsPerChunk, each compressed on its own.
+ * Transforms are quantized (1/100 cm location, 16 bit rotation axes, scale only when not 1).
+ * Goes through ISaveGameSystem directly (same storage as UGameplayStatics::SaveGameToSlot) so writing can happen on a worker thread.
+ * Slots written by SaveGameToSlot before this existed are still loaded.
+ */
+struct ACTIONROGUELIKE_API FSaveGameFile
+{
+public:
+
+	/* Game thread : copy everything the worker needs out of the save object */
+	static void MakeSnapshot(const USSaveGame* SaveGame, FSaveGameSnapshot& OutSnapshot);
+
+	/* Any thread : serialize, compress and write the snapshot to the slot. Snapshot is not modified, FArchive just can't take const data. */
+	static void Write(FSaveGameSnapshot& Snapshot, const FString& SlotName, int32 UserIndex, FSaveGameWriteResult& OutResult);
+
+	/* Any thread : same as Write without the disk IO */
+	static bool WriteToMemory(FSaveGameSnapshot& Snapshot, TArray<uint8>& OutFileData, FSaveGameWriteResult& OutResult);
+
+	/* Any thread : raw contents of the slot, false if it does not exist */
+	static bool ReadSlot(const FString& SlotName, int32 UserIndex, TArray<uint8>& OutFileData);
+
+	/* Any thread : reads the requested sections of FileData into OutSnapshot.
+	False if FileData is corrupt or was written by SaveGameToSlot (bOutEngineFormat, only LoadFromMemory can read those, on the game thread). */
+	static bool ReadSnapshot(const TArray<uint8>& FileData, ESaveGameSections Sections, FSaveGameSnapshot& OutSnapshot, const FString& DebugName, bool& bOutEngineFormat);
+
+	/* Game thread : moves the requested sections of Snapshot into SaveGame */
+	static void ApplySnapshot(FSaveGameSnapshot& Snapshot, USSaveGame* SaveGame, ESaveGameSections Sections);
+
+	/* Game thread : nullptr if the slot does not exist or could not be read (any format) */
+	static USSaveGame* Load(const FString& SlotName, int32 UserIndex, ESaveGameSections Sections = ESaveGameSections::All);
+
+	/* Game thread : DebugName is only used for logging */
+	static USSaveGame* LoadFromMemory(const TArray<uint8>& FileData, ESaveGameSections Sections, const FString& DebugName);
+
+	/* Logs size and read/write throughput of SaveGame in our format vs. UGameplayStatics::SaveGameToMemory */
+	static void LogFormatComparison(USSaveGame* SaveGame, int32 NumIterations = 10);
+
+	/* Actors per compressed chunk, chunks are (de)compressed independently */
+	static const int32 ActorsPerChunk = 256;
+
+private:
+
+	static void SerializeActor(FArchive& Ar, FActorSaveData& ActorData);
+
+	static void SerializePlayer(FArchive& Ar, FPlayerSaveData& PlayerData);
+
+	static void SerializeQuantizedTransform(FArchive& Ar, FTransform& Transform);
+
+	/* Versions 1-2 : a single zlib blob with full transforms */
+	static bool LoadSingleBlob(FArchive& FileReader, const TArray<uint8>& FileData, FSaveGameSnapshot& OutSnapshot, const FString& DebugName);
+};
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SSaveGameInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI)
+class USSaveGameInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors with 'SaveGame' state. Only actors implementing this AND registered with USSaveGameRegistrySubsystem (usually in BeginPlay) are saved and restored.
+ * Restoring still calls ISGameplayInterface::OnActorLoaded when implemented.
+ */
+class ACTIONROGUELIKE_API ISSaveGameInterface
+{
+	GENERATED_BODY()
+
+	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
+public:
+
+	/* Higher priority actors are saved and restored first (default 0). Read once on registration. */
+	UFUNCTION(BlueprintNativeEvent)
+	int32 GetSavePriority() const;
+};
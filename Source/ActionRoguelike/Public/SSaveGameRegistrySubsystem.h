@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SSaveGameRegistrySubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSaveActorRegistryChanged, AActor*);
+
+/**
+ * Keeps track of all savable actors (ISSaveGameInterface) in the world.
+ * Actors register themselves on BeginPlay and unregister on EndPlay,
+ * so saving and loading only touch these instead of iterating the whole actor list with FActorIterator.
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USSaveGameRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/* Registered actors and their save priority */
+	UPROPERTY()
+	TMap<AActor*, int32> ActorPriorities;
+
+	/* Rebuilt from ActorPriorities by GetActors after actors were added or removed */
+	UPROPERTY()
+	TArray<AActor*> SortedActors;
+
+	bool bNeedsSort;
+
+public:
+
+	/* Actor must implement ISSaveGameInterface */
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	void RegisterActor(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	void UnregisterActor(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	int32 GetNumActors() const;
+
+	/* All registered actors, highest save priority first */
+	const TArray<AActor*>& GetActors();
+
+	/* Print registered actors and save priority per class */
+	void LogStats() const;
+
+	/* Actor joined after the map started (spawned, streamed in), GameMode includes it in the next incremental save */
+	FOnSaveActorRegistryChanged OnActorRegistered;
+
+	/* Called from the actor's EndPlay, before it is gone. Also fires for streaming and map teardown, check IsActorBeingDestroyed(). */
+	FOnSaveActorRegistryChanged OnActorUnregistered;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};
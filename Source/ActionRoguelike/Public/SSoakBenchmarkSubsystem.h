@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SSoakBenchmarkSubsystem.generated.h"
+
+class AController;
+
+/* Per frame timings, all in milliseconds */
+struct FSoakFrameSample
+{
+	float FrameMs;
+
+	/* Engine's own game thread time (GGameThreadTime), excludes waiting on render/RHI */
+	float GameThreadMs;
+
+	/* UWorld::Tick from after incoming net until all actors/components (bots, AI controllers, movement, physics) are done */
+	float WorldTickMs;
+
+	/* Net driver TickDispatch (incoming) + TickFlush (replication, outgoing) */
+	float NetMs;
+
+	int32 AliveBots;
+};
+
+/**
+ * Headless soak benchmark, sizes servers without hand-watching 'stat STANFORD' in the editor.
+ * Keeps N bots alive (su.ForceBotCount), adds scripted players spamming PrimaryAttack (USAction_ProjectileAttack) at them,
+ * samples frame timings for a fixed duration and writes a per-frame CSV + JSON summary to Saved/Profiling/Soak.
+ * A 'CsvProfile' capture runs alongside for the engine's own breakdown (physics, AI, net categories).
+ *
+ * Started from the command line, e.g. :
+ * UE4Editor ActionRoguelike /Game/Maps/<BenchmarkMap> -game -nullrhi -unattended -SoakBots=200 -SoakDuration=120 -SoakPlayers=4
+ * Exits once done when running -unattended.
+ * Or through the ActionRoguelike.Soak automation test (50/200/500 bots), which needs a map with a NavMesh for the bots (-SoakMap=, TestLevel by default).
+ */
+UCLASS()
+class ACTIONROGUELIKE_API USSoakBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	int32 TargetBots;
+
+	/* Seconds to sample once warmed up */
+	float Duration;
+
+	/* Max seconds to wait for the bot count to reach TargetBots before sampling anyway */
+	float MaxWarmUpTime;
+
+	int32 NumScriptedPlayers;
+
+	float FireInterval;
+
+	/* Name of the output files, defaults to Soak_<TargetBots> */
+	FString RunName;
+
+	bool bRunning;
+
+	/* Started by StartFromCommandLine, quit the game once the results are written (when -unattended) */
+	bool bExitWhenDone;
+
+	bool bSampling;
+
+	double StartTime;
+
+	double SampleStartTime;
+
+	TArray<FSoakFrameSample> Samples;
+
+	/* Controllers rather than pawns, GameMode respawns them like regular players when killed */
+	UPROPERTY()
+	TArray<AController*> ScriptedPlayers;
+
+	FTimerHandle TimerHandle_Fire;
+
+	FTimerHandle TimerHandle_WarmUp;
+
+	/* Time stamps (FPlatformTime::Cycles) within the current UWorld::Tick, in the order they happen */
+	uint32 WorldTickStartCycles;
+	uint32 PostTickDispatchCycles;
+	uint32 PostActorTickCycles;
+
+	/* Timings of the last complete world tick, turned into a sample on the next tick start (once GGameThreadTime is known) */
+	float LastWorldTickMs;
+	float LastNetMs;
+	bool bHasLastFrame;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle PostTickDispatchHandle;
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle PostTickFlushHandle;
+
+	void SpawnScriptedPlayers();
+
+	void FireScriptedPlayers();
+
+	void CheckWarmUp();
+
+	void BeginSampling();
+
+	void FinishRun();
+
+	void WriteResults() const;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void OnPostTickDispatch();
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void OnPostTickFlush();
+
+	void UnbindTickDelegates();
+
+public:
+
+	/* Starts the run if the command line contains -SoakBots=N. Called by GameMode on StartPlay (server only). */
+	void StartFromCommandLine();
+
+	/* Server only. Keeps InTargetBots alive and samples for InDuration seconds once warmed up, RunName defaults to Soak_<InTargetBots>. */
+	void StartRun(int32 InTargetBots, float InDuration, int32 InNumScriptedPlayers, const FString& InRunName = FString());
+
+	bool IsRunning() const { return bRunning; }
+
+	/* Frames sampled by the current or last run */
+	int32 GetNumSamples() const { return Samples.Num(); }
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+};